@@ -1,10 +1,31 @@
 #include <bits/stdc++.h>
+#include "maze_core.hpp"
 using namespace std;
 
 struct Point {
     int r, c;
 };
 
+// File output through one large buffer; numbers are formatted with to_chars
+struct BufferedWriter {
+    FILE *f;
+    vector<char> buf = vector<char>(1 << 20);
+    size_t used = 0;
+
+    explicit BufferedWriter(FILE *f) : f(f) {}
+    ~BufferedWriter() { flush(); fclose(f); }
+    void flush() { fwrite(buf.data(), 1, used, f); used = 0; }
+    void put(char ch) {
+        if (used == buf.size()) flush();
+        buf[used++] = ch;
+    }
+    void put(const string &s) { for (char ch : s) put(ch); }
+    void num(long long v) {
+        if (buf.size() - used < 24) flush();
+        used = to_chars(buf.data() + used, buf.data() + buf.size(), v).ptr - buf.data();
+    }
+};
+
 int main() {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -29,54 +50,38 @@ int main() {
         getline(fin, maze[i]);
     fin.close();
 
-    vector<vector<int>> dist(rows, vector<int>(cols, -1));
-    vector<vector<Point>> parent(rows, vector<Point>(cols, {-1, -1}));
-    queue<Point> q;
-    vector<Point> visited_order; // store all visited cells
-
-    int dr[4] = {-1, 1, 0, 0};
-    int dc[4] = {0, 0, -1, 1};
-
-    q.push({sr, sc});
-    dist[sr][sc] = 0;
-
-    while (!q.empty()) {
-        auto [r, c] = q.front(); q.pop();
-        visited_order.push_back({r, c});
-
-        if (r == gr && c == gc)
-            break;
-
-        for (int i = 0; i < 4; i++) {
-            int nr = r + dr[i], nc = c + dc[i];
-            if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
-                maze[nr][nc] != '1' && dist[nr][nc] == -1) {
-                dist[nr][nc] = dist[r][c] + 1;
-                parent[nr][nc] = {r, c};
-                q.push({nr, nc});
-            }
-        }
-    }
-
-    ofstream fout("solution.txt");
-    if (!fout) {
+    // 4-connected, unit-cost breadth-first search from maze_core over the
+    // text rows; packed labels keep a visited bit and the 2-bit move that
+    // reached each cell, 3 bits per cell. The order in which cells are
+    // reached and dequeued streams to bfs_trace.mzt through a bounded ring
+    // instead of being held in memory until the end (not in builds with
+    // -DMAZE_NO_TRACE).
+    using Bfs = maze_core::Search<maze_core::Four, maze_core::UnitCost, maze_core::CharGrid, maze_core::Fifo,
+                                  maze_core::PackedLabels<maze_core::Four>>;
+    Bfs bfs;
+#ifdef MAZE_TRACE
+    maze_trace::TraceWriter trace("bfs_trace.mzt", rows, cols);
+    if (!trace.isOpen()) cerr << "Warning: could not create 'bfs_trace.mzt'\n";
+    bfs.setTrace(&trace);
+#endif
+    vector<Point> path = bfs.run<Point>(maze_core::CharGrid{&maze, rows, cols}, {}, sr, sc, gr, gc);
+#ifdef MAZE_TRACE
+    if (trace.isOpen() && !trace.close()) cerr << "Warning: could not write 'bfs_trace.mzt'\n";
+#endif
+
+    FILE *file = fopen("solution.txt", "wb");
+    if (!file) {
         cerr << "Error: could not create 'solution.txt'\n";
         return 1;
     }
+    BufferedWriter fout(file);
 
-    if (dist[gr][gc] == -1) {
-        fout << "No path found.\n";
-        fout.close();
+    if (path.empty()) {
+        fout.put("No path found.\n");
         cout << "No path found.\n";
         return 0;
     }
 
-    // Reconstruct path
-    vector<Point> path;
-    for (Point p = {gr, gc}; p.r != -1; p = parent[p.r][p.c])
-        path.push_back(p);
-    reverse(path.begin(), path.end());
-
     // Mark path in maze
     for (auto &p : path)
         if (maze[p.r][p.c] == '0')
@@ -87,32 +92,42 @@ int main() {
     double exec_time = double(end_time - start_time) / CLOCKS_PER_SEC;
 
     // Rough memory usage estimate
-    size_t memory_used = sizeof(maze)
-        + rows * cols * (sizeof(int) * 2 + sizeof(Point))
-        + sizeof(dist) + sizeof(parent) + sizeof(q) + sizeof(path)
-        + sizeof(visited_order);
-
-    // Write to file
-    fout << "Path found! Length = " << dist[gr][gc] << "\n\n";
-    fout << "Traversed cells: " << visited_order.size() << "\n";
-    fout << "Path cells: " << path.size() << "\n\n";
-
-    fout << "Path (row, col):\n";
-    for (auto &p : path)
-        fout << "(" << p.r << ", " << p.c << ")\n";
-
-    fout << "\nAll traversed cells:\n";
-    for (auto &p : visited_order)
-        fout << "(" << p.r << ", " << p.c << ")\n";
+    size_t memory_used = sizeof(maze) + bfs.bytes()
+        + sizeof(bfs) + sizeof(path);
+
+    // Write to file. The path is its start cell plus run-length moves, e.g.
+    // "1 1 D6R4U2" = from (1,1) go 6 down, 4 right, 2 up (a count of 1 is omitted)
+    fout.put("Path found! Length = "); fout.num(path.size() - 1); fout.put("\n\n");
+    fout.put("Traversed cells: "); fout.num(bfs.expanded()); fout.put('\n');
+    fout.put("Path cells: "); fout.num(path.size()); fout.put("\n\n");
+
+    fout.put("Path (start row col, then U/D/L/R moves with repeat counts):\n");
+    fout.num(sr); fout.put(' '); fout.num(sc);
+    if (path.size() > 1) fout.put(' ');
+    for (size_t i = 1; i < path.size(); ) {
+        int mr = path[i].r - path[i - 1].r, mc = path[i].c - path[i - 1].c;
+        size_t j = i + 1;
+        while (j < path.size() && path[j].r - path[j - 1].r == mr && path[j].c - path[j - 1].c == mc) j++;
+        fout.put(mr < 0 ? 'U' : mr > 0 ? 'D' : mc < 0 ? 'L' : 'R');
+        if (j - i > 1) fout.num(j - i);
+        i = j;
+    }
+    fout.put('\n');
 
-    fout << "\nMaze with path ('.' marks path):\n";
-    for (auto &row : maze)
-        fout << row << '\n';
+#ifdef MAZE_TRACE
+    fout.put("\nTraversal order: bfs_trace.mzt (replay it with report_gui.py)\n");
+#endif
 
-    fout << "\nExecution Time: " << fixed << setprecision(5) << exec_time << " seconds\n";
-    fout << "Approx Memory Used: " << memory_used / 1024.0 << " KB\n";
+    fout.put("\nMaze with path ('.' marks path):\n");
+    for (auto &row : maze) {
+        fout.put(row); fout.put('\n');
+    }
 
-    fout.close();
+    char stats[128];
+    snprintf(stats, sizeof stats, "\nExecution Time: %.5f seconds\nApprox Memory Used: %.5f KB\n",
+             exec_time, memory_used / 1024.0);
+    fout.put(stats);
+    fout.flush();
 
     cout << "Solution saved to 'bfs_solution.txt'\n";
     cout << "Execution Time: " << exec_time << " seconds\n";
@@ -5,10 +5,14 @@
 #include <algorithm>
 #include <chrono>
 #include <thread>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "maze_core.hpp"
 
 #ifdef _WIN32
     #include <windows.h>
-    #define CLEAR_SCREEN() system("cls")
     
     // Enable ANSI color codes on Windows 10+
     void enableWindowsColors() {
@@ -22,7 +26,6 @@
         }
     }
 #else
-    #define CLEAR_SCREEN() system("clear")
     void enableWindowsColors() {} // No-op on non-Windows
 #endif
 
@@ -41,86 +44,131 @@ struct Cell {
 // For right-hand rule: turn right, go straight, turn left, turn back
 // For left-hand rule: turn left, go straight, turn right, turn back
 
-// Helper function to sleep for milliseconds (cross-platform)
-void sleep_ms(int milliseconds) {
-    this_thread::sleep_for(chrono::milliseconds(milliseconds));
-}
+// Terminal view of a wall-following run. The maze is drawn once; after that
+// each frame only rewrites the cells changed since the previous frame (cursor
+// positioning + one colored char each) and the status line, all built into
+// one buffer and written with a single fwrite. Steps are paced by elapsed time
+// (stepsPerSecond) and frames are capped at `fps`: when steps come faster than
+// frames, everything changed in between is drawn together in the next frame.
+class AnsiRenderer {
+public:
+    AnsiRenderer(int startRow, int startCol, int endRow, int endCol, double stepsPerSecond, double fps)
+        : startRow(startRow), startCol(startCol), endRow(endRow), endCol(endCol),
+          stepInterval(stepsPerSecond > 0 ? 1.0 / stepsPerSecond : 0), frameInterval(fps > 0 ? 1.0 / fps : 0) {}
 
-// Visualize the maze with current position and path
-void visualizeMaze(vector<string>& maze, int currentRow, int currentCol, 
-                   vector<Cell>& path, int startRow, int startCol, 
-                   int endRow, int endCol, int stepCount, bool useRightHand) {
-    int height = maze.size();
-    int width = maze[0].size();
-    
-    // Create a copy of the maze for visualization
-    vector<string> display = maze;
-    
-    // Mark visited path cells (but not the current position)
-    for (const Cell& cell : path) {
-        if (cell.row == startRow && cell.col == startCol) {
-            display[cell.row][cell.col] = 'S';
-        } else if (cell.row == endRow && cell.col == endCol) {
-            display[cell.row][cell.col] = 'E';
-        } else if (!(cell.row == currentRow && cell.col == currentCol)) {
-            display[cell.row][cell.col] = '*';
+    // Clear the screen and draw the whole maze once
+    void begin(const vector<string>& maze, const string& title) {
+        screen = maze;
+        width = screen.empty() ? 0 : (int)screen[0].size();
+        for (const Cell& cell : {Cell(startRow, startCol), Cell(endRow, endCol)})
+            if (cell.row >= 0 && cell.row < (int)screen.size() && cell.col >= 0 && cell.col < width)
+                screen[cell.row][cell.col] = cell.row == startRow && cell.col == startCol ? 'S' : 'E';
+        queued.assign(screen.size() * width, 0);
+        dirty.clear();
+        out = "\033[?25l\033[2J\033[H\n=== Maze Solver - " + title + " ===\n\n";
+        out += "Legend: S=Start, E=End, @=Current, *=Path, 1=Wall, 0=Empty\n\n";
+        for (const string& row : screen) {
+            for (char ch : row) appendCell(ch);
+            out += '\n';
         }
+        flush();
+        start = lastFrame = chrono::steady_clock::now();
+        stepsSeen = 0;
     }
-    
-    // Mark current position with a special character
-    if (currentRow >= 0 && currentRow < height && currentCol >= 0 && currentCol < width) {
-        if (currentRow == startRow && currentCol == startCol) {
-            display[currentRow][currentCol] = 'S';
-        } else if (currentRow == endRow && currentCol == endCol) {
-            display[currentRow][currentCol] = 'E';
-        } else {
-            display[currentRow][currentCol] = '@';  // Current position
+
+    // The walker moved from (fromRow, fromCol) to (row, col)
+    void step(int fromRow, int fromCol, int row, int col, int stepCount, size_t pathLength) {
+        set(fromRow, fromCol, '*');
+        set(row, col, '@');
+        current = Cell(row, col);
+        this->stepCount = stepCount;
+        this->pathLength = pathLength;
+        ++stepsSeen;
+        // Wait until this step is due instead of sleeping a fixed time, so
+        // the time spent drawing counts towards the interval
+        if (stepInterval > 0)
+            this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                                                 chrono::duration<double>(stepsSeen * stepInterval)));
+        const auto now = chrono::steady_clock::now();
+        if (chrono::duration<double>(now - lastFrame).count() >= frameInterval) drawFrame(now);
+    }
+
+    // Draw whatever is pending and park the cursor below the maze
+    void finish(const string& message) {
+        drawFrame(chrono::steady_clock::now());
+        moveTo((int)screen.size() + HEADER_ROWS + 1, 0);
+        out += message + "\n\033[?25h";
+        flush();
+    }
+
+private:
+    static const int HEADER_ROWS = 5;          // blank, title, status, legend, blank
+    int startRow, startCol, endRow, endCol;
+    double stepInterval, frameInterval;
+    vector<string> screen;                     // symbols as of the next frame
+    int width = 0;
+    vector<char> queued;                       // cell already in `dirty`
+    vector<Cell> dirty;                        // cells changed since the last frame
+    string out;
+    chrono::steady_clock::time_point start, lastFrame;
+    long long stepsSeen = 0;
+    Cell current;
+    int stepCount = 0;
+    size_t pathLength = 0;
+
+    // S and E keep their letters under @ and *
+    void set(int r, int c, char ch) {
+        if (r < 0 || r >= (int)screen.size() || c < 0 || c >= width) return;
+        if ((r == startRow && c == startCol) || (r == endRow && c == endCol)) ch = screen[r][c];
+        if (screen[r][c] == ch) return;
+        screen[r][c] = ch;
+        char& q = queued[(size_t)r * width + c];
+        if (!q) { q = 1; dirty.push_back(Cell(r, c)); }
+    }
+    void moveTo(int row, int col) {
+        out += "\033[" + to_string(row + 1) + ";" + to_string(col + 1) + "H";
+    }
+    void appendCell(char ch) {
+        switch (ch) {
+            case '@': out += "\033[1;33m@\033[0m"; break;   // Yellow for current
+            case 'S': out += "\033[1;32mS\033[0m"; break;   // Green for start
+            case 'E': out += "\033[1;31mE\033[0m"; break;   // Red for end
+            case '*': out += "\033[1;36m*\033[0m"; break;   // Cyan for path
+            case '1': out += "\033[1;37m1\033[0m"; break;   // White for walls
+            default: out += ch;
         }
     }
-    
-    // Clear screen and print
-    CLEAR_SCREEN();
-    
-    string ruleName = useRightHand ? "Right-Hand Rule" : "Left-Hand Rule";
-    cout << "\n=== Maze Solver - " << ruleName << " ===" << endl;
-    cout << "Step: " << stepCount << " | Path Length: " << path.size() << " | Current: (" 
-         << currentRow << ", " << currentCol << ")" << endl;
-    cout << "Legend: S=Start, E=End, @=Current, *=Path, 1=Wall, 0=Empty\n" << endl;
-    
-    // Print the maze
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            char ch = display[i][j];
-            // Add some color coding (basic, works on most terminals)
-            if (ch == '@') {
-                cout << "\033[1;33m@\033[0m";  // Yellow for current
-            } else if (ch == 'S') {
-                cout << "\033[1;32mS\033[0m";  // Green for start
-            } else if (ch == 'E') {
-                cout << "\033[1;31mE\033[0m";  // Red for end
-            } else if (ch == '*') {
-                cout << "\033[1;36m*\033[0m";  // Cyan for path
-            } else if (ch == '1') {
-                cout << "\033[1;37m1\033[0m";  // White for walls
-            } else {
-                cout << ch;
-            }
+    void drawFrame(chrono::steady_clock::time_point now) {
+        for (const Cell& cell : dirty) {
+            queued[(size_t)cell.row * width + cell.col] = 0;
+            moveTo(cell.row + HEADER_ROWS, cell.col);
+            appendCell(screen[cell.row][cell.col]);
         }
-        cout << endl;
+        dirty.clear();
+        moveTo(2, 0);
+        out += "Step: " + to_string(stepCount) + " | Path Length: " + to_string(pathLength) +
+               " | Current: (" + to_string(current.row) + ", " + to_string(current.col) + ")\033[K";
+        flush();
+        lastFrame = now;
     }
-    cout << endl;
-}
+    void flush() {
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+        out.clear();
+    }
+};
 
-// Wall following algorithm with visualization (right-hand or left-hand rule)
-vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int startCol, 
-                                     int endRow, int endCol, bool useRightHand = true, 
-                                     bool visualize = true, int delayMs = 100) {
+// Wall following algorithm (right-hand or left-hand rule). With a view every
+// move is reported to it; without one the walk runs at full speed.
+vector<Cell> solveMazeWallFollowing(const vector<string>& maze, int startRow, int startCol,
+                                     int endRow, int endCol, bool useRightHand = true,
+                                     AnsiRenderer* view = nullptr) {
     int height = maze.size();
     int width = maze[0].size();
     
-    // Direction vectors: North, East, South, West
-    int dr[] = {-1, 0, 1, 0};
-    int dc[] = {0, 1, 0, -1};
+    // Headings are maze_core::Four's directions: North, East, South, West
+    using Dirs = maze_core::Four;
+    const maze_core::CharGrid grid{&maze, height, width};
     
     vector<Cell> path;
     int currentRow = startRow;
@@ -129,10 +177,7 @@ vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int star
     // Determine initial direction - try to find a valid direction from start
     int direction = 1; // Start facing East (right)
     for (int d = 0; d < 4; d++) {
-        int newRow = currentRow + dr[d];
-        int newCol = currentCol + dc[d];
-        if (newRow >= 0 && newRow < height && newCol >= 0 && newCol < width && 
-            maze[newRow][newCol] != '1') {
+        if (maze_core::openAt(grid, currentRow + Dirs::dr[d], currentCol + Dirs::dc[d])) {
             direction = d;
             break;
         }
@@ -143,20 +188,12 @@ vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int star
     
     path.push_back(Cell(currentRow, currentCol));
     
-    // Initial visualization
-    if (visualize) {
-        visualizeMaze(maze, currentRow, currentCol, path, startRow, startCol, endRow, endCol, stepCount, useRightHand);
-        sleep_ms(delayMs);
-    }
+    if (view) view->begin(maze, useRightHand ? "Right-Hand Rule" : "Left-Hand Rule");
     
     while (stepCount < maxSteps) {
         // Check if we reached the end
         if (currentRow == endRow && currentCol == endCol) {
-            if (visualize) {
-                visualizeMaze(maze, currentRow, currentCol, path, startRow, startCol, endRow, endCol, stepCount, useRightHand);
-                cout << "SUCCESS! Path found in " << stepCount << " steps!" << endl;
-                sleep_ms(2000); // Pause to show final result
-            }
+            if (view) view->finish("SUCCESS! Path found in " + to_string(stepCount) + " steps!");
             return path;
         }
         
@@ -169,27 +206,27 @@ vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int star
             priorities[0] = (direction + 1) % 4; // Turn right
             priorities[1] = direction;            // Go forward
             priorities[2] = (direction + 3) % 4; // Turn left
-            priorities[3] = (direction + 2) % 4; // Turn back
+            priorities[3] = Dirs::reverse(direction); // Turn back
         } else {
             // Left-hand rule: left, forward, right, back
             priorities[0] = (direction + 3) % 4; // Turn left
             priorities[1] = direction;            // Go forward
             priorities[2] = (direction + 1) % 4; // Turn right
-            priorities[3] = (direction + 2) % 4; // Turn back
+            priorities[3] = Dirs::reverse(direction); // Turn back
         }
         
         bool moved = false;
         // Try each direction in priority order
         for (int i = 0; i < 4; i++) {
             int tryDir = priorities[i];
-            int newRow = currentRow + dr[tryDir];
-            int newCol = currentCol + dc[tryDir];
+            int newRow = currentRow + Dirs::dr[tryDir];
+            int newCol = currentCol + Dirs::dc[tryDir];
             
             // Check if the cell is valid (not a wall and within bounds)
-            if (newRow >= 0 && newRow < height && newCol >= 0 && newCol < width && 
-                maze[newRow][newCol] != '1') {
+            if (maze_core::openAt(grid, newRow, newCol)) {
                 
                 // Move to the new cell
+                const int fromRow = currentRow, fromCol = currentCol;
                 currentRow = newRow;
                 currentCol = newCol;
                 direction = tryDir;
@@ -202,11 +239,7 @@ vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int star
                 moved = true;
                 stepCount++;
                 
-                // Visualize after each move
-                if (visualize) {
-                    visualizeMaze(maze, currentRow, currentCol, path, startRow, startCol, endRow, endCol, stepCount, useRightHand);
-                    sleep_ms(delayMs);
-                }
+                if (view) view->step(fromRow, fromCol, currentRow, currentCol, stepCount, path.size());
                 
                 break;
             }
@@ -219,10 +252,11 @@ vector<Cell> solveMazeWallFollowing(vector<string>& maze, int startRow, int star
     }
     
     // If we didn't reach the end, return empty path
+    if (view) view->finish("Gave up after " + to_string(stepCount) + " steps.");
     return vector<Cell>();
 }
 
-void printMazeWithPath(vector<string>& maze, vector<Cell>& path, int startRow, int startCol, int endRow, int endCol) {
+void printMazeWithPath(const vector<string>& maze, const vector<Cell>& path, int startRow, int startCol, int endRow, int endCol) {
     int height = maze.size();
     int width = maze[0].size();
     
@@ -247,13 +281,31 @@ void printMazeWithPath(vector<string>& maze, vector<Cell>& path, int startRow, i
     }
 }
 
-int main() {
+// Usage: MazeSequentialIterator [maze.txt] [--headless] [--speed STEPS_PER_SEC] [--fps N]
+// --headless runs both rules at full speed without drawing or prompts and
+// reports their timings.
+int main(int argc, char** argv) {
+    string mazePath = "maze.txt";
+    bool headless = false;
+    double stepsPerSecond = 12.5, fps = 60;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (a == "--headless") headless = true;
+        else if (a == "--speed" && i + 1 < argc) stepsPerSecond = atof(argv[++i]);
+        else if (a == "--fps" && i + 1 < argc) fps = atof(argv[++i]);
+        else if (a[0] != '-') mazePath = a;
+        else {
+            cerr << "Usage: " << argv[0] << " [maze.txt] [--headless] [--speed STEPS_PER_SEC] [--fps N]" << endl;
+            return 1;
+        }
+    }
+
     // Enable ANSI colors on Windows
     enableWindowsColors();
     
-    ifstream file("maze.txt");
+    ifstream file(mazePath);
     if (!file.is_open()) {
-        cerr << "Error: Could not open maze.txt" << endl;
+        cerr << "Error: Could not open " << mazePath << endl;
         return 1;
     }
     
@@ -281,14 +333,30 @@ int main() {
     cout << "Maze dimensions: " << height << " x " << width << endl;
     cout << "Start: (" << startRow << ", " << startCol << ")" << endl;
     cout << "End: (" << endRow << ", " << endCol << ")" << endl;
+
+    if (headless) {
+        for (bool rightHand : {true, false}) {
+            auto t0 = chrono::steady_clock::now();
+            vector<Cell> walk = solveMazeWallFollowing(maze, startRow, startCol, endRow, endCol, rightHand);
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+            cout << "\n=== " << (rightHand ? "Right" : "Left") << "-Hand Rule ===" << endl;
+            if (walk.empty()) cout << "No path found (" << us << " us)" << endl;
+            else cout << "Path found! Length: " << walk.size() << " cells in " << us << " us" << endl;
+            if (!walk.empty() && height <= 120 && width <= 120)
+                printMazeWithPath(maze, walk, startRow, startCol, endRow, endCol);
+        }
+        return 0;
+    }
+
     cout << "\nPress Enter to start visualization..." << endl;
     cin.get();
+    AnsiRenderer view(startRow, startCol, endRow, endCol, stepsPerSecond, fps);
     
     // Solve using right-hand rule wall following with visualization
-    vector<Cell> path = solveMazeWallFollowing(maze, startRow, startCol, endRow, endCol, true, true, 80);
+    vector<Cell> path = solveMazeWallFollowing(maze, startRow, startCol, endRow, endCol, true, &view);
     
     if (!path.empty()) {
-        CLEAR_SCREEN();
+        cout << "\033[2J\033[H";
         cout << "\n=== Right-Hand Rule Results ===" << endl;
         cout << "Path found! Length: " << path.size() << " cells" << endl;
         printMazeWithPath(maze, path, startRow, startCol, endRow, endCol);
@@ -299,10 +367,10 @@ int main() {
     }
     
     // Also try left-hand rule for comparison
-    vector<Cell> path2 = solveMazeWallFollowing(maze, startRow, startCol, endRow, endCol, false, true, 80);
+    vector<Cell> path2 = solveMazeWallFollowing(maze, startRow, startCol, endRow, endCol, false, &view);
     
     if (!path2.empty()) {
-        CLEAR_SCREEN();
+        cout << "\033[2J\033[H";
         cout << "\n=== Left-Hand Rule Results ===" << endl;
         cout << "Path found! Length: " << path2.size() << " cells" << endl;
         printMazeWithPath(maze, path2, startRow, startCol, endRow, endCol);
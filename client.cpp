@@ -0,0 +1,168 @@
+#include <bits/stdc++.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+// Load generator for main.cpp's --serve mode.
+// Usage: client SOCKET MAZE [--algo N] [--clients C] [--requests R] [--random-ends]
+// Each client opens one connection and sends R requests back to back; the
+// round-trip latency of every request is collected and summarised at the end.
+
+// Must match the structs in main.cpp
+static const uint32_t REQUEST_MAGIC = 0x51525a4d;   // "MZRQ"
+static const uint32_t RESPONSE_MAGIC = 0x53525a4d;  // "MZRS"
+
+struct SolveRequest {
+    uint32_t magic;
+    uint8_t algo, reserved[3];
+    int32_t sr, sc, er, ec;
+    uint32_t pathLen;
+};
+struct SolveResponse {
+    uint32_t magic;
+    int32_t status;
+    int32_t sr, sc;
+    uint64_t solveNanos;
+    int64_t cost;
+    uint32_t steps, reserved;
+};
+
+static const char *ALGO_NAMES[] = {"BFS", "Dijkstra", "A*", "JPS", "Dial", "Bidirectional BFS", "HPA*", "Bit-parallel BFS"};
+
+static bool readFull(int fd, void *buf, size_t n) {
+    char *p = static_cast<char*>(buf);
+    while (n > 0) {
+        ssize_t got = read(fd, p, n);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got; n -= size_t(got);
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void *buf, size_t n) {
+    const char *p = static_cast<const char*>(buf);
+    while (n > 0) {
+        ssize_t put = write(fd, p, n);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put; n -= size_t(put);
+    }
+    return true;
+}
+
+struct ClientStats {
+    vector<double> latencyUs;
+    long long ok = 0, noPath = 0, failed = 0;
+    uint64_t solveNanos = 0;
+};
+
+// Random open cells for --random-ends, read once from the text maze
+static vector<pair<int,int>> openCells(const string &path) {
+    vector<pair<int,int>> cells;
+    ifstream fin(path);
+    int h, w, a, b, c, d;
+    if (!(fin >> h >> w >> a >> b >> c >> d)) return cells;
+    string line;
+    getline(fin, line);
+    for (int r = 0; r < h && getline(fin, line); ++r)
+        for (int col = 0; col < (int)line.size() && col < w; ++col)
+            if (line[col] != '1') cells.push_back({r, col});
+    return cells;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " SOCKET MAZE [--algo N] [--clients C] [--requests R] [--random-ends]\n";
+        for (int i = 0; i < 8; ++i) cerr << "  algo " << i << ": " << ALGO_NAMES[i] << '\n';
+        return 1;
+    }
+    string socketPath = argv[1], mazePath = argv[2];
+    int algo = 0, clients = 4, requests = 100;
+    bool randomEnds = false;
+    for (int i = 3; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--algo" && i + 1 < argc) algo = atoi(argv[++i]);
+        else if (a == "--clients" && i + 1 < argc) clients = max(1, atoi(argv[++i]));
+        else if (a == "--requests" && i + 1 < argc) requests = max(1, atoi(argv[++i]));
+        else if (a == "--random-ends") randomEnds = true;
+    }
+    if (algo < 0 || algo > 7) { cerr << "Unknown algorithm " << algo << '\n'; return 1; }
+
+    vector<pair<int,int>> cells;
+    if (randomEnds) {
+        cells = openCells(mazePath);
+        if (cells.empty()) { cerr << "--random-ends needs a readable text maze\n"; return 1; }
+    }
+
+    vector<ClientStats> stats(clients);
+    vector<thread> workers;
+    auto t0 = chrono::steady_clock::now();
+    for (int t = 0; t < clients; ++t) workers.emplace_back([&, t] {
+        ClientStats &st = stats[t];
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socketPath.c_str(), sizeof addr.sun_path - 1);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+            st.failed = requests;
+            if (fd >= 0) close(fd);
+            return;
+        }
+        mt19937 rng(12345u + t);
+        vector<char> msg(sizeof(SolveRequest) + mazePath.size());
+        vector<uint8_t> moves;
+        for (int i = 0; i < requests; ++i) {
+            SolveRequest req{};
+            req.magic = REQUEST_MAGIC;
+            req.algo = uint8_t(algo);
+            req.sr = req.sc = req.er = req.ec = -1;
+            if (randomEnds) {
+                auto s = cells[rng() % cells.size()], e = cells[rng() % cells.size()];
+                req.sr = s.first; req.sc = s.second; req.er = e.first; req.ec = e.second;
+            }
+            req.pathLen = uint32_t(mazePath.size());
+            memcpy(msg.data(), &req, sizeof req);
+            memcpy(msg.data() + sizeof req, mazePath.data(), mazePath.size());
+
+            auto s0 = chrono::steady_clock::now();
+            SolveResponse resp;
+            if (!writeFull(fd, msg.data(), msg.size()) || !readFull(fd, &resp, sizeof resp) ||
+                resp.magic != RESPONSE_MAGIC) { st.failed += requests - i; break; }
+            moves.resize((resp.steps + 3) / 4);
+            if (!readFull(fd, moves.data(), moves.size())) { st.failed += requests - i; break; }
+            auto s1 = chrono::steady_clock::now();
+
+            st.latencyUs.push_back(chrono::duration<double, micro>(s1 - s0).count());
+            st.solveNanos += resp.solveNanos;
+            if (resp.status == 0) st.ok++;
+            else if (resp.status == 1) st.noPath++;
+            else st.failed++;
+        }
+        close(fd);
+    });
+    for (auto &w : workers) w.join();
+    double wallSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    ClientStats total;
+    for (auto &st : stats) {
+        total.latencyUs.insert(total.latencyUs.end(), st.latencyUs.begin(), st.latencyUs.end());
+        total.ok += st.ok; total.noPath += st.noPath; total.failed += st.failed;
+        total.solveNanos += st.solveNanos;
+    }
+    auto &lat = total.latencyUs;
+    sort(lat.begin(), lat.end());
+    auto pct = [&](double p) { return lat.empty() ? 0.0 : lat[min(lat.size() - 1, size_t(p * (lat.size() - 1) + 0.5))]; };
+
+    cout << fixed << setprecision(1);
+    cout << "Algorithm: " << ALGO_NAMES[algo] << ", " << clients << " clients x " << requests << " requests\n";
+    cout << "Completed: " << lat.size() << " (ok " << total.ok << ", no path " << total.noPath
+         << ", failed " << total.failed << ")\n";
+    cout << "Throughput: " << (wallSec > 0 ? lat.size() / wallSec : 0.0) << " req/s\n";
+    cout << "Latency us: p50 " << pct(0.50) << "  p90 " << pct(0.90) << "  p99 " << pct(0.99)
+         << "  max " << (lat.empty() ? 0.0 : lat.back()) << '\n';
+    if (!lat.empty())
+        cout << "Mean solve time inside server: " << total.solveNanos / 1000.0 / lat.size() << " us\n";
+    return total.failed ? 2 : 0;
+}
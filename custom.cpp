@@ -3,8 +3,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
-#include <queue>
-#include <limits>
+
+#include "maze_core.hpp"
 
 using namespace std;
 
@@ -45,68 +45,21 @@ void printMazeWithPath(vector<string>& maze, vector<Cell>& path, int startRow, i
 }
 
 // Dijkstra's shortest path on a grid maze (cost 1 per move)
-// Returns the shortest path from start to end
+// Returns the shortest path from start to end. The search is maze_core's,
+// specialised for 4 neighbours, unit cost, text rows and a binary heap, with
+// packed labels (a visited bit and a 2-bit parent move per cell).
 vector<Cell> solveMazeDijkstra(vector<string>& maze, int startRow, int startCol,
                                int endRow, int endCol) {
     const int height = static_cast<int>(maze.size());
     const int width = height > 0 ? static_cast<int>(maze[0].size()) : 0;
     if (height == 0 || width == 0) return {};
 
-    // Movements: up, right, down, left
-    const int dr[4] = {-1, 0, 1, 0};
-    const int dc[4] = {0, 1, 0, -1};
-
-    const int INF = std::numeric_limits<int>::max();
-    vector<vector<int>> dist(height, vector<int>(width, INF));
-    vector<vector<Cell>> parent(height, vector<Cell>(width, Cell(-1, -1)));
-
-    struct Node {
-        int dist;
-        int row;
-        int col;
-        bool operator>(const Node& other) const { return dist > other.dist; }
-    };
-
-    auto isFree = [&](int r, int c) -> bool {
-        if (r < 0 || r >= height || c < 0 || c >= width) return false;
-        // Treat any non-'1' as traversable (includes '0', 'S', 'E')
-        return maze[r][c] != '1';
-    };
-
-    priority_queue<Node, vector<Node>, greater<Node>> pq;
-    dist[startRow][startCol] = 0;
-    pq.push(Node{0, startRow, startCol});
-
-    while (!pq.empty()) {
-        Node cur = pq.top();
-        pq.pop();
-        if (cur.dist != dist[cur.row][cur.col]) continue; // stale
-        if (cur.row == endRow && cur.col == endCol) break;
-
-        for (int k = 0; k < 4; k++) {
-            int nr = cur.row + dr[k];
-            int nc = cur.col + dc[k];
-            if (!isFree(nr, nc)) continue;
-            int nd = cur.dist + 1; // uniform cost
-            if (nd < dist[nr][nc]) {
-                dist[nr][nc] = nd;
-                parent[nr][nc] = Cell(cur.row, cur.col);
-                pq.push(Node{nd, nr, nc});
-            }
-        }
-    }
-
-    if (dist[endRow][endCol] == INF) return {};
-
-    // Reconstruct shortest path
-    vector<Cell> path;
-    for (Cell at = Cell(endRow, endCol); at.row != -1; at = parent[at.row][at.col]) {
-        path.push_back(at);
-        if (at.row == startRow && at.col == startCol) break;
-    }
-    reverse(path.begin(), path.end());
-
-    return path;
+    using Dijkstra = maze_core::Search<maze_core::Four, maze_core::UnitCost,
+                                       maze_core::CharGrid, maze_core::BinaryHeap,
+                                       maze_core::PackedLabels<maze_core::Four>>;
+    Dijkstra search;
+    return search.run<Cell>(maze_core::CharGrid{&maze, height, width}, {},
+                            startRow, startCol, endRow, endCol);
 }
 
 int main() {
@@ -1,247 +1,3262 @@
-#include <bits/stdc++.h>
-#ifdef _WIN32
-#include <windows.h>
-#include <psapi.h>
-#pragma comment(lib, "Psapi.lib")
-#endif
-
-using namespace std;
-
-struct Cell { int row, col; };
-
-static bool operator==(const Cell &a, const Cell &b) { return a.row == b.row && a.col == b.col; }
-
-// Read maze from maze.txt (format matches your generator)
-// First line: height width
-// Second: start_row start_col
-// Third: end_row end_col
-// Then height lines of maze using '1','0','S','E'
-struct MazeData {
-    int height{}, width{};
-    int sr{}, sc{}, er{}, ec{};
-    vector<string> grid;
-};
-
-static bool readMaze(const string &path, MazeData &m) {
-    ifstream in(path);
-    if (!in.is_open()) return false;
-    in >> m.height >> m.width;
-    in >> m.sr >> m.sc;
-    in >> m.er >> m.ec;
-    string line; getline(in, line);
-    m.grid.resize(m.height);
-    for (int i = 0; i < m.height; ++i) getline(in, m.grid[i]);
-    return true;
-}
-
-static bool isFree(const MazeData &m, int r, int c) {
-    if (r < 0 || r >= m.height || c < 0 || c >= m.width) return false;
-    return m.grid[r][c] != '1';
-}
-
-// Pretty print maze with a path
-static void printMazeWithPath(const MazeData &m, const vector<Cell> &path) {
-    vector<string> disp = m.grid;
-    for (const auto &p : path) {
-        if (p.row == m.sr && p.col == m.sc) disp[p.row][p.col] = 'S';
-        else if (p.row == m.er && p.col == m.ec) disp[p.row][p.col] = 'E';
-        else disp[p.row][p.col] = '*';
-    }
-    cout << "\nMaze with path (S,E,*,1,0):\n";
-    for (auto &row : disp) cout << row << '\n';
-}
-
-#ifdef _WIN32
-static size_t getCurrentMemoryBytes() {
-    PROCESS_MEMORY_COUNTERS pmc{};
-    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
-        return static_cast<size_t>(pmc.WorkingSetSize);
-    }
-    return 0;
-}
-#else
-static size_t getCurrentMemoryBytes() { return 0; }
-#endif
-
-// Dijkstra (uniform cost)
-static vector<Cell> solveDijkstra(const MazeData &m) {
-    const int dr[4] = {-1,0,1,0};
-    const int dc[4] = {0,1,0,-1};
-    const int H = m.height, W = m.width;
-    const int INF = INT_MAX/4;
-    vector<vector<int>> dist(H, vector<int>(W, INF));
-    vector<vector<Cell>> parent(H, vector<Cell>(W, Cell{-1,-1}));
-    struct Node { int d,r,c; bool operator>(const Node&o) const {return d>o.d;} };
-    priority_queue<Node, vector<Node>, greater<Node>> pq;
-    dist[m.sr][m.sc] = 0; pq.push({0,m.sr,m.sc});
-    while(!pq.empty()){
-        auto cur = pq.top(); pq.pop();
-        if (cur.d != dist[cur.r][cur.c]) continue;
-        if (cur.r == m.er && cur.c == m.ec) break;
-        for(int k=0;k<4;k++){
-            int nr = cur.r+dr[k], nc = cur.c+dc[k];
-            if(!isFree(m,nr,nc)) continue;
-            int nd = cur.d+1;
-            if(nd<dist[nr][nc]){ dist[nr][nc]=nd; parent[nr][nc]=Cell{cur.r,cur.c}; pq.push({nd,nr,nc}); }
-        }
-    }
-    if (dist[m.er][m.ec] >= INF) return {};
-    vector<Cell> path; Cell at{m.er,m.ec};
-    for(;;){ path.push_back(at); if(at.row==m.sr && at.col==m.sc) break; at=parent[at.row][at.col]; }
-    reverse(path.begin(), path.end());
-    return path;
-}
-
-// BFS shortest path
-static vector<Cell> solveBFS(const MazeData &m){
-    const int dr[4] = {-1,0,1,0};
-    const int dc[4] = {0,1,0,-1};
-    const int H=m.height,W=m.width;
-    vector<vector<int>> dist(H, vector<int>(W,-1));
-    vector<vector<Cell>> parent(H, vector<Cell>(W, Cell{-1,-1}));
-    queue<Cell> q; q.push({m.sr,m.sc}); dist[m.sr][m.sc]=0;
-    while(!q.empty()){
-        auto cur=q.front(); q.pop();
-        if(cur.row==m.er && cur.col==m.ec) break;
-        for(int k=0;k<4;k++){
-            int nr=cur.row+dr[k], nc=cur.col+dc[k];
-            if(!isFree(m,nr,nc) || dist[nr][nc]!=-1) continue;
-            dist[nr][nc]=dist[cur.row][cur.col]+1; parent[nr][nc]=cur; q.push({nr,nc});
-        }
-    }
-    if(dist[m.er][m.ec]==-1) return {};
-    vector<Cell> path; Cell at{m.er,m.ec};
-    for(;;){ path.push_back(at); if(at.row==m.sr && at.col==m.sc) break; at=parent[at.row][at.col]; }
-    reverse(path.begin(), path.end());
-    return path;
-}
-
-// DFS (stack) - may not be shortest
-static vector<Cell> solveDFS(const MazeData &m){
-    const int dr[4] = {-1,0,1,0};
-    const int dc[4] = {0,1,0,-1};
-    const int H=m.height,W=m.width;
-    vector<vector<int>> vis(H, vector<int>(W,0));
-    vector<vector<Cell>> parent(H, vector<Cell>(W, Cell{-1,-1}));
-    stack<Cell> st; st.push({m.sr,m.sc}); vis[m.sr][m.sc]=1;
-    while(!st.empty()){
-        auto cur=st.top(); st.pop();
-        if(cur.row==m.er && cur.col==m.ec) break;
-        for(int k=0;k<4;k++){
-            int nr=cur.row+dr[k], nc=cur.col+dc[k];
-            if(!isFree(m,nr,nc) || vis[nr][nc]) continue;
-            vis[nr][nc]=1; parent[nr][nc]=cur; st.push({nr,nc});
-        }
-    }
-    if(!vis[m.er][m.ec]) return {};
-    vector<Cell> path; Cell at{m.er,m.ec};
-    for(;;){ path.push_back(at); if(at.row==m.sr && at.col==m.sc) break; at=parent[at.row][at.col]; }
-    reverse(path.begin(), path.end());
-    return path;
-}
-
-// Linear scan (very simple dynamic reachability, not optimal but deterministic)
-static vector<Cell> solveLinear(const MazeData &m){
-    const int H=m.height,W=m.width;
-    vector<vector<int>> reachable(H, vector<int>(W,0));
-    vector<vector<Cell>> parent(H, vector<Cell>(W, Cell{-1,-1}));
-    reachable[m.sr][m.sc]=1;
-    // Sweep until no change
-    bool changed=true; int iter=0; const int dr[4]={-1,0,1,0}; const int dc[4]={0,1,0,-1};
-    while(changed && ++iter<=H*W){
-        changed=false;
-        for(int r=0;r<H;r++) for(int c=0;c<W;c++) if(isFree(m,r,c)){
-            if(reachable[r][c]) continue;
-            for(int k=0;k<4;k++){
-                int pr=r+dr[k], pc=c+dc[k];
-                if(pr<0||pr>=H||pc<0||pc>=W) continue;
-                if(reachable[pr][pc] && isFree(m,pr,pc)){
-                    reachable[r][c]=1; parent[r][c]=Cell{pr,pc}; changed=true; break;
-                }
-            }
-        }
-    }
-    if(!reachable[m.er][m.ec]) return {};
-    vector<Cell> path; Cell at{m.er,m.ec};
-    for(;;){ path.push_back(at); if(at.row==m.sr && at.col==m.sc) break; at=parent[at.row][at.col]; }
-    reverse(path.begin(), path.end());
-    return path;
-}
-
-struct RunResult {
-    string name;
-    vector<Cell> path;
-    long long ms{};
-    size_t memBytes{};
-};
-
-template <class Solver>
-static RunResult runOne(const string &name, const MazeData &m, Solver solver){
-    size_t memBefore = getCurrentMemoryBytes();
-    auto t0 = chrono::steady_clock::now();
-    auto path = solver(m);
-    auto t1 = chrono::steady_clock::now();
-    size_t memAfter = getCurrentMemoryBytes();
-    RunResult r; r.name=name; r.path=std::move(path); r.ms = chrono::duration_cast<chrono::milliseconds>(t1-t0).count(); r.memBytes = (memAfter?memAfter:0); // working set snapshot
-    return r;
-}
-
-static void saveResults(const vector<RunResult> &all, const RunResult &fastest, const string &outPath, const MazeData &m){
-    ofstream out(outPath);
-    out << "Maze: " << m.height << "x" << m.width << " Start:("<<m.sr<<","<<m.sc<<") End:("<<m.er<<","<<m.ec<<")\n\n";
-    for (const auto &r: all){
-        out << "Algorithm: " << r.name << "\n";
-        out << "Time(ms): " << r.ms << "\n";
-        out << "Memory(bytes, working set): " << r.memBytes << "\n";
-        out << "Path length: " << r.path.size() << "\n";
-        out << "Path: ";
-        for (size_t i=0;i<r.path.size();++i){ out << "("<<r.path[i].row<<","<<r.path[i].col<<")" << (i+1<r.path.size()?" -> ":""); }
-        out << "\n\n";
-    }
-    out << "FASTEST: " << fastest.name << " (" << fastest.ms << " ms)\n";
-    out << "Fastest path length: " << fastest.path.size() << "\n";
-    out << "Fastest path: ";
-    for (size_t i=0;i<fastest.path.size();++i){ out << "("<<fastest.path[i].row<<","<<fastest.path[i].col<<")" << (i+1<fastest.path.size()?" -> ":""); }
-    out << "\n";
-}
-
-int main(){
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    MazeData m; if(!readMaze("maze.txt", m)){ cerr << "Failed to read maze.txt" << '\n'; return 1; }
-    cout << "Maze: " << m.height << "x" << m.width << " Start:("<<m.sr<<","<<m.sc<<") End:("<<m.er<<","<<m.ec<<")\n";
-
-    vector<RunResult> results;
-    results.push_back(runOne("Dijkstra (custom.cpp)", m, solveDijkstra));
-    results.push_back(runOne("BFS (BFS.cpp)", m, solveBFS));
-    results.push_back(runOne("DFS (stl.cpp)", m, solveDFS));
-    results.push_back(runOne("Linear Scan (mazesequential.cpp)", m, solveLinear));
-
-    for (const auto &r: results){
-        cout << "\n["<< r.name << "]\n";
-        cout << "Time: " << r.ms << " ms\n";
-        cout << "Memory (working set bytes): " << r.memBytes << "\n";
-        cout << "Path length: " << r.path.size() << "\n";
-        printMazeWithPath(m, r.path);
-    }
-
-    // Fastest by time
-    const RunResult *fastest = nullptr;
-    for (const auto &r: results){ if(!fastest || r.ms < fastest->ms) fastest = &r; }
-    if (fastest){
-        cout << "\nFASTEST: " << fastest->name << " (" << fastest->ms << " ms)\n";
-    }
-
-    saveResults(results, *fastest, "results.txt", m);
-    ofstream fastestOut("fastest.txt");
-    if (fastest){
-        fastestOut << fastest->name << "\n";
-        for (size_t i=0;i<fastest->path.size();++i){
-            fastestOut << fastest->path[i].row << " " << fastest->path[i].col << (i+1<fastest->path.size()?"\n":"");
-        }
-    }
-    return 0;
-}
-
-
+#include <bits/stdc++.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+#if defined(MAZE_COUNT_ALLOCS) && !defined(_WIN32)
+#include <malloc.h>
+#endif
+#include "maze_core.hpp"
+
+using namespace std;
+
+struct Cell { int row, col; };
+
+// Row-major cell id r * width + c. 32-bit unsigned like maze_core's ids, so
+// mazes up to 2^32 cells (50k x 50k and beyond) index without overflow;
+// loadMaze refuses larger ones. Index arithmetic such as id + DR[k] * W wraps
+// modulo 2^32 and lands on the right neighbour.
+typedef uint32_t CellId;
+static inline CellId cellId(int r, int c, int W){ return CellId(size_t(r) * W + c); }
+static const uint64_t MAX_CELLS = uint64_t(1) << 32;
+static const CellId NO_CELL = CellId(-1);     // never a real id, since cells < MAX_CELLS
+static bool fitsCellIds(const string &path, int height, int width){
+    if (uint64_t(height) * uint64_t(width) < MAX_CELLS) return true;
+    cerr << path << ": " << height << "x" << width << " has too many cells for 32-bit cell ids\n";
+    return false;
+}
+
+// Bit-packed maze grid. One bit per cell (1 = open) in a single allocation,
+// padded with a one-cell wall border so probing (r+-1, c+-1) from any real
+// cell never needs a bounds check. Rows are padded to 64-byte boundaries.
+// Each cell also carries a 4-bit mask of its open neighbours: bit k is set
+// when (r+DR[k], c+DC[k]) is open, using the up/right/down/left order below.
+// GridStorage is a read-only view: the arrays live either in heap buffers
+// made by GridBuilder or directly inside a memory-mapped .mzb file.
+static constexpr auto DR = maze_core::Four::dr;
+static constexpr auto DC = maze_core::Four::dc;
+
+static int paddedWordsPerRow(int w) { return ((w + 2 + 63) / 64 + 7) & ~7; }
+
+struct GridStorage {
+    int height{}, width{};
+    int wordsPerRow{};          // 64-bit words per padded row (multiple of 8)
+    int maxCost{1};
+    const uint64_t *bits{};     // (height+2) * wordsPerRow words
+    const uint8_t *nbr{};       // two 4-bit neighbour masks per byte
+    const uint8_t *weight{};    // cost of entering each cell; null = every cell costs 1
+    shared_ptr<const void> backing; // keeps the heap buffers or file mapping alive
+
+    size_t wordCount() const { return size_t(height + 2) * wordsPerRow; }
+    // r in [-1,height], c in [-1,width]; the border is always wall
+    bool open(int r, int c) const {
+        size_t pr = size_t(r + 1), pc = size_t(c + 1);
+        return (bits[pr * wordsPerRow + (pc >> 6)] >> (pc & 63)) & 1;
+    }
+    unsigned neighbors(int r, int c) const {
+        size_t i = size_t(r) * width + c;
+        return (nbr[i >> 1] >> ((i & 1) * 4)) & 0xF;
+    }
+    bool weighted() const { return weight != nullptr; }
+    int cost(int r, int c) const { return weight ? weight[size_t(r) * width + c] : 1; }
+};
+
+// Heap-backed grid under construction; finish() derives the neighbour masks
+// and hands the buffers over to a GridStorage.
+struct GridBuilder {
+    int height{}, width{}, wordsPerRow{}, maxCost{1};
+    vector<uint64_t> bits;
+    vector<uint8_t> nbr, weight;
+
+    GridBuilder(int h, int w) : height(h), width(w), wordsPerRow(paddedWordsPerRow(w)),
+        bits(size_t(h + 2) * wordsPerRow, 0), nbr((size_t(h) * w + 1) / 2, 0) {}
+    bool open(int r, int c) const {
+        size_t pr = size_t(r + 1), pc = size_t(c + 1);
+        return (bits[pr * wordsPerRow + (pc >> 6)] >> (pc & 63)) & 1;
+    }
+    void setOpen(int r, int c){
+        size_t pr = size_t(r + 1), pc = size_t(c + 1);
+        bits[pr * wordsPerRow + (pc >> 6)] |= uint64_t(1) << (pc & 63);
+    }
+    void setCost(int r, int c, int v){
+        if (weight.empty()) weight.assign(size_t(height) * width, 1);
+        weight[size_t(r) * width + c] = uint8_t(v);
+        maxCost = max(maxCost, v);
+    }
+    GridStorage finish(){
+        for (int r = 0; r < height; ++r) for (int c = 0; c < width; ++c) {
+            unsigned mask = 0;
+            if (open(r, c)) for (int k = 0; k < 4; ++k) mask |= unsigned(open(r + DR[k], c + DC[k])) << k;
+            size_t i = size_t(r) * width + c;
+            nbr[i >> 1] |= uint8_t(mask << ((i & 1) * 4));
+        }
+        auto owned = make_shared<GridBuilder>(std::move(*this));
+        GridStorage g;
+        g.height = owned->height; g.width = owned->width;
+        g.wordsPerRow = owned->wordsPerRow; g.maxCost = owned->maxCost;
+        g.bits = owned->bits.data(); g.nbr = owned->nbr.data();
+        g.weight = owned->weight.empty() ? nullptr : owned->weight.data();
+        g.backing = owned;
+        return g;
+    }
+};
+
+// Read maze from maze.txt (format matches your generator)
+// First line: height width
+// Second: start_row start_col
+// Third: end_row end_col
+// Then height lines of maze using '1','0','S','E'
+// Optional terrain: a digit '2'..'9' is an open cell that costs that much to
+// enter ('0', 'S' and 'E' cost 1).
+struct MazeData {
+    int height{}, width{};
+    int sr{}, sc{}, er{}, ec{};
+    GridStorage grid;
+};
+
+// GridStorage as a maze_core grid policy: the wall border makes one-cell
+// probes safe and the neighbour masks answer all four directions in one read
+struct BitGrid {
+    static constexpr bool padded = true, masks = true;
+    const GridStorage *g;
+    int height() const { return g->height; }
+    int width() const { return g->width; }
+    bool open(int r, int c) const { return g->open(r, c); }
+    unsigned neighbors(int r, int c) const { return g->neighbors(r, c); }
+};
+
+static bool readMaze(const string &path, MazeData &m) {
+    ifstream in(path);
+    if (!in.is_open()) return false;
+    in >> m.height >> m.width;
+    in >> m.sr >> m.sc;
+    in >> m.er >> m.ec;
+    if (!in || m.height <= 0 || m.width <= 0 || !fitsCellIds(path, m.height, m.width)) return false;
+    string line; getline(in, line);
+    GridBuilder b(m.height, m.width);
+    for (int i = 0; i < m.height; ++i) {
+        if (!getline(in, line)) break;
+        const int n = min<int>(m.width, (int)line.size());
+        for (int j = 0; j < n; ++j) {
+            if (line[j] == '1') continue;
+            b.setOpen(i, j);
+            if (line[j] >= '2' && line[j] <= '9') b.setCost(i, j, line[j] - '0');
+        }
+    }
+    m.grid = b.finish();
+    return true;
+}
+
+// Binary maze format (.mzb), little-endian. A 64-byte header is followed by
+// sections that start on 64-byte boundaries and hold GridStorage's arrays
+// verbatim, so a mapped file is used in place without parsing or copying:
+//   bits   (height+2) * wordsPerRow uint64 words, padded rows, 1 = open
+//   nbr    (height*width+1)/2 bytes of 4-bit neighbour masks
+//   weight height*width entry costs (only when MZB_WEIGHTED is set)
+static const char MZB_MAGIC[4] = {'M','Z','B','1'};
+static const uint32_t MZB_VERSION = 1;
+static const uint32_t MZB_WEIGHTED = 1;
+
+struct MzbHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t height, width, sr, sc, er, ec;
+    uint32_t wordsPerRow, flags, maxCost, reserved;
+    uint64_t nbrOffset, weightOffset;   // bits start right after the header
+};
+static_assert(sizeof(MzbHeader) == 64, "MzbHeader must stay 64 bytes");
+
+static uint64_t alignTo64(uint64_t x) { return (x + 63) & ~uint64_t(63); }
+
+static MzbHeader mzbLayout(const MazeData &m){
+    MzbHeader h{};
+    memcpy(h.magic, MZB_MAGIC, 4);
+    h.version = MZB_VERSION;
+    h.height = m.height; h.width = m.width;
+    h.sr = m.sr; h.sc = m.sc; h.er = m.er; h.ec = m.ec;
+    h.wordsPerRow = uint32_t(paddedWordsPerRow(m.width));
+    h.flags = m.grid.weighted() ? MZB_WEIGHTED : 0;
+    h.maxCost = uint32_t(m.grid.maxCost);
+    h.nbrOffset = alignTo64(sizeof(MzbHeader) + uint64_t(m.height + 2) * h.wordsPerRow * 8);
+    h.weightOffset = alignTo64(h.nbrOffset + (uint64_t(m.height) * m.width + 1) / 2);
+    return h;
+}
+
+// Write a loaded maze (from either format) as .mzb
+static bool writeMazeBinary(const MazeData &m, const string &path){
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) return false;
+    const MzbHeader h = mzbLayout(m);
+    const char zeros[64] = {};
+    auto padTo = [&](uint64_t off){ out.write(zeros, streamsize(off - uint64_t(out.tellp()))); };
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(reinterpret_cast<const char*>(m.grid.bits), streamsize(m.grid.wordCount() * 8));
+    padTo(h.nbrOffset);
+    out.write(reinterpret_cast<const char*>(m.grid.nbr), streamsize((size_t(m.height) * m.width + 1) / 2));
+    if (h.flags & MZB_WEIGHTED) {
+        padTo(h.weightOffset);
+        out.write(reinterpret_cast<const char*>(m.grid.weight), streamsize(size_t(m.height) * m.width));
+    }
+    return bool(out);
+}
+
+// Every solver trusts the grid, so a mapped one is checked once: the padding
+// around the real cells must be wall, each neighbour mask must match the open
+// bits around its cell, and entry costs must lie in 1..maxCost
+static bool validGrid(const GridStorage &g){
+    const size_t wpr = size_t(g.wordsPerRow);
+    for (int pr = 0; pr < g.height + 2; ++pr)
+        for (size_t w = 0; w < wpr; ++w) {
+            uint64_t allowed = 0;                    // padded columns 1..width of real rows
+            const size_t lo = max<size_t>(1, w * 64), hi = min<size_t>(size_t(g.width) + 1, w * 64 + 64);
+            if (pr >= 1 && pr <= g.height && lo < hi)
+                allowed = (hi - lo == 64 ? ~uint64_t(0) : (uint64_t(1) << (hi - lo)) - 1) << (lo - w * 64);
+            if (g.bits[size_t(pr) * wpr + w] & ~allowed) return false;
+        }
+    for (int r = 0; r < g.height; ++r)
+        for (int c = 0; c < g.width; ++c) {
+            unsigned mask = 0;
+            if (g.open(r, c)) for (int k = 0; k < 4; ++k) mask |= unsigned(g.open(r + DR[k], c + DC[k])) << k;
+            if (g.neighbors(r, c) != mask) return false;
+        }
+    if (g.weighted())
+        for (size_t i = 0; i < size_t(g.height) * g.width; ++i)
+            if (g.weight[i] < 1 || g.weight[i] > g.maxCost) return false;
+    return true;
+}
+
+// Map a .mzb file read-only and point the grid straight into it
+static bool loadMazeBinary(const string &path, MazeData &m){
+    size_t size = 0;
+    const char *base = nullptr;
+    shared_ptr<const void> mapping;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER li{};
+    GetFileSizeEx(file, &li);
+    size = size_t(li.QuadPart);
+    HANDLE map = size ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!map) return false;
+    base = static_cast<const char*>(MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(map);
+    if (!base) return false;
+    mapping = shared_ptr<const void>(base, [](const void *p){ UnmapViewOfFile(p); });
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+    size = size_t(st.st_size);
+    void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const char*>(p);
+    mapping = shared_ptr<const void>(p, [size](const void *q){ munmap(const_cast<void*>(q), size); });
+#endif
+    if (size < sizeof(MzbHeader)) return false;
+    MzbHeader h;
+    memcpy(&h, base, sizeof h);
+    if (memcmp(h.magic, MZB_MAGIC, 4) != 0 || h.version != MZB_VERSION || h.height <= 0 || h.width <= 0) return false;
+    if (!fitsCellIds(path, h.height, h.width)) return false;
+    m.height = h.height; m.width = h.width;
+    m.sr = h.sr; m.sc = h.sc; m.er = h.er; m.ec = h.ec;
+    const MzbHeader want = mzbLayout(m);
+    const uint64_t cells = uint64_t(h.height) * h.width;
+    if (h.wordsPerRow != want.wordsPerRow || h.nbrOffset != want.nbrOffset) return false;
+    if (size < h.nbrOffset + (cells + 1) / 2) return false;
+    if ((h.flags & MZB_WEIGHTED) && (h.weightOffset != want.weightOffset || size < h.weightOffset + cells)) return false;
+    if ((h.flags & MZB_WEIGHTED) && (h.maxCost < 1 || h.maxCost > 255)) return false;
+    GridStorage &g = m.grid;
+    g.height = h.height; g.width = h.width;
+    g.wordsPerRow = int(h.wordsPerRow);
+    g.maxCost = (h.flags & MZB_WEIGHTED) ? int(h.maxCost) : 1;
+    g.bits = reinterpret_cast<const uint64_t*>(base + sizeof(MzbHeader));
+    g.nbr = reinterpret_cast<const uint8_t*>(base + h.nbrOffset);
+    g.weight = (h.flags & MZB_WEIGHTED) ? reinterpret_cast<const uint8_t*>(base + h.weightOffset) : nullptr;
+    g.backing = mapping;
+    return validGrid(g);
+}
+
+// Load either format, picking .mzb by its magic bytes
+static bool loadMaze(const string &path, MazeData &m){
+    char magic[4] = {};
+    ifstream probe(path, ios::binary);
+    if (!probe.is_open()) return false;
+    probe.read(magic, 4);
+    probe.close();
+    if (!(memcmp(magic, MZB_MAGIC, 4) == 0 ? loadMazeBinary(path, m) : readMaze(path, m))) return false;
+    // solvers index straight from S and E, so both must be open cells of the grid
+    auto inside = [&](int r, int c){ return r >= 0 && r < m.height && c >= 0 && c < m.width && m.grid.open(r, c); };
+    if (!inside(m.sr, m.sc) || !inside(m.er, m.ec)) {
+        cerr << path << ": start or end is outside the maze or on a wall\n";
+        return false;
+    }
+    return true;
+}
+
+static string mazeRowText(const MazeData &m, int r) {
+    string row(m.width, '1');
+    for (int c = 0; c < m.width; ++c) if (m.grid.open(r, c)) row[c] = char('0' + (m.grid.cost(r, c) > 1 ? m.grid.cost(r, c) : 0));
+    if (r == m.sr && m.sc >= 0 && m.sc < m.width) row[m.sc] = 'S';
+    if (r == m.er && m.ec >= 0 && m.ec < m.width) row[m.ec] = 'E';
+    return row;
+}
+
+// Console printing is for small mazes only; larger ones go to --render
+static const int PRINT_MAX_SIDE = 120;
+static bool printable(const MazeData &m){ return m.height <= PRINT_MAX_SIDE && m.width <= PRINT_MAX_SIDE; }
+
+// Pretty print maze with a path, one row at a time
+static void printMazeWithPath(const MazeData &m, const vector<Cell> &path) {
+    vector<uint64_t> ids;                     // path cells in row-major order
+    ids.reserve(path.size());
+    for (const auto &p : path) ids.push_back(uint64_t(p.row) * m.width + p.col);
+    sort(ids.begin(), ids.end());
+    cout << "\nMaze with path (S,E,*,1,0):\n";
+    auto it = ids.begin();
+    for (int r = 0; r < m.height; ++r) {
+        string row = mazeRowText(m, r);
+        for (; it != ids.end() && *it < uint64_t(r + 1) * m.width; ++it) {
+            char &ch = row[*it % m.width];
+            if (ch != 'S' && ch != 'E') ch = '*';
+        }
+        cout << row << '\n';
+    }
+}
+
+// ---- Memory accounting ---------------------------------------------------
+// runOne samples resident memory around every solver. On Linux the peak
+// (VmHWM) is reset first through /proc/self/clear_refs, so the reported peak
+// growth belongs to that solver alone; where the reset is unavailable only
+// growth past the earlier process-wide peak shows up, a lower bound.
+struct MemorySample { size_t rss = 0, peakRss = 0; };
+
+#ifdef _WIN32
+static MemorySample sampleMemory() {
+    MemorySample s;
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        s.rss = static_cast<size_t>(pmc.WorkingSetSize);
+        s.peakRss = static_cast<size_t>(pmc.PeakWorkingSetSize);
+    }
+    return s;
+}
+static bool resetPeakMemory() { return false; }
+#else
+static MemorySample sampleMemory() {
+    MemorySample s;
+    if (FILE *f = fopen("/proc/self/status", "r")) {
+        char line[256];
+        unsigned long long kb;
+        while (fgets(line, sizeof line, f)) {
+            if (sscanf(line, "VmRSS: %llu", &kb) == 1) s.rss = size_t(kb) * 1024;
+            else if (sscanf(line, "VmHWM: %llu", &kb) == 1) s.peakRss = size_t(kb) * 1024;
+        }
+        fclose(f);
+    }
+    if (!s.peakRss) {
+        rusage ru{};
+        if (getrusage(RUSAGE_SELF, &ru) == 0) s.peakRss = size_t(ru.ru_maxrss) * 1024;
+    }
+    return s;
+}
+// Writing "5" to clear_refs resets VmHWM to the current RSS (Linux 4.0+)
+static bool resetPeakMemory() {
+    const int fd = ::open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) return false;
+    const bool ok = ::write(fd, "5", 1) == 1;
+    ::close(fd);
+    return ok;
+}
+#endif
+
+// Build with -DMAZE_COUNT_ALLOCS to route global new/delete through counters.
+// Sizes come from the allocator (malloc_usable_size / _msize), so they include
+// its rounding and no header is needed. Off by default: the counters are
+// shared atomics and slow down allocation-heavy solvers.
+#ifdef MAZE_COUNT_ALLOCS
+static atomic<size_t> allocBytesTotal{0}, allocCountTotal{0}, liveBytes{0}, peakLiveBytes{0};
+
+#ifdef _WIN32
+static size_t blockSize(void *p) { return _msize(p); }
+static size_t alignedBlockSize(void *p, size_t align) { return _aligned_msize(p, align, 0); }
+static void *alignedAlloc(size_t n, size_t align) { return _aligned_malloc(n, align); }
+static void alignedFree(void *p) { _aligned_free(p); }
+#else
+static size_t blockSize(void *p) { return malloc_usable_size(p); }
+static size_t alignedBlockSize(void *p, size_t) { return malloc_usable_size(p); }
+static void *alignedAlloc(size_t n, size_t align) { return aligned_alloc(align, (n + align - 1) / align * align); }
+static void alignedFree(void *p) { free(p); }
+#endif
+
+static void noteAlloc(size_t n) {
+    allocBytesTotal.fetch_add(n, memory_order_relaxed);
+    allocCountTotal.fetch_add(1, memory_order_relaxed);
+    const size_t live = liveBytes.fetch_add(n, memory_order_relaxed) + n;
+    size_t peak = peakLiveBytes.load(memory_order_relaxed);
+    while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {}
+}
+
+void *operator new(size_t n) {
+    void *p = malloc(n ? n : 1);
+    if (!p) throw bad_alloc();
+    noteAlloc(blockSize(p));
+    return p;
+}
+void *operator new[](size_t n) { return ::operator new(n); }
+void *operator new(size_t n, align_val_t a) {
+    void *p = alignedAlloc(n ? n : 1, size_t(a));
+    if (!p) throw bad_alloc();
+    noteAlloc(alignedBlockSize(p, size_t(a)));
+    return p;
+}
+void *operator new[](size_t n, align_val_t a) { return ::operator new(n, a); }
+// GCC flags free() inside a replaced operator delete as a mismatch
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept {
+    if (!p) return;
+    liveBytes.fetch_sub(blockSize(p), memory_order_relaxed);
+    free(p);
+}
+void operator delete[](void *p) noexcept { ::operator delete(p); }
+void operator delete(void *p, size_t) noexcept { ::operator delete(p); }
+void operator delete[](void *p, size_t) noexcept { ::operator delete(p); }
+void operator delete(void *p, align_val_t a) noexcept {
+    if (!p) return;
+    liveBytes.fetch_sub(alignedBlockSize(p, size_t(a)), memory_order_relaxed);
+    alignedFree(p);
+}
+void operator delete[](void *p, align_val_t a) noexcept { ::operator delete(p, a); }
+void operator delete(void *p, size_t, align_val_t a) noexcept { ::operator delete(p, a); }
+void operator delete[](void *p, size_t, align_val_t a) noexcept { ::operator delete(p, a); }
+#endif
+
+// Sum of entry costs along a path (the start cell is free)
+static long long pathCost(const MazeData &m, const vector<Cell> &path){
+    long long total = 0;
+    for (size_t i = 1; i < path.size(); ++i) total += m.grid.cost(path[i].row, path[i].col);
+    return total;
+}
+
+// Cells taken off a frontier, summed over one solver run so the benchmark can
+// report expansions per second. Solvers count locally and publish on return.
+static atomic<long long> cellsExpanded{0};
+
+// Cooperative cancellation for portfolio races: the racing thread points
+// currentCancel at the race's token and solvers poll stopRequested() every
+// 1024 expansions (BFS-style solvers once per level), returning no path once
+// another solver has won. Outside a race the pointer is null.
+class CancelToken {
+public:
+    void cancel(){ stop.store(true, memory_order_relaxed); }
+    bool cancelled() const { return stop.load(memory_order_relaxed); }
+private:
+    atomic<bool> stop{false};
+};
+static thread_local const CancelToken *currentCancel = nullptr;
+static inline bool stopRequested(){ return currentCancel && currentCancel->cancelled(); }
+
+struct ExpansionCounter {
+    long long n = 0;
+    ~ExpansionCounter() { cellsExpanded.fetch_add(n, memory_order_relaxed); }
+    // Counts one expansion; true when the solver should give up
+    bool expand(){ return (++n & 1023) == 0 && stopRequested(); }
+};
+
+// ---- Parent directions ---------------------------------------------------------
+// A parent in a 4-connected grid is always one of the four neighbours, so the
+// solvers record the direction index k a cell was reached by (cell = parent +
+// DR/DC[k]) in 2 bits instead of a parent cell. traceDirections walks such a
+// map back from `at` to `root`; dirOf(cell) returns k. The path is counted
+// first so the result is the walk's only allocation.
+template <class DirOf>
+static vector<Cell> traceDirections(CellId at, CellId root, int W, DirOf dirOf){
+    size_t n = 1;
+    for (CellId x = at; x != root; ++n) { const int k = dirOf(x); x -= DR[k] * W + DC[k]; }
+    vector<Cell> path(n);
+    for (CellId x = at;;) {
+        path[--n] = Cell{int(x / CellId(W)), int(x % CellId(W))};
+        if (x == root) break;
+        const int k = dirOf(x);
+        x -= DR[k] * W + DC[k];
+    }
+    return path;
+}
+
+// ---- Core solvers -------------------------------------------------------------
+// Dijkstra, Dial, A*, BFS and DFS are instantiations of maze_core::Search over
+// BitGrid. Weighted mazes get the ByteCost specialisation and plain ones
+// UnitCost, so the common case has no per-step weight load. Searches that are
+// not one Search (bidirectional, JPS, junction graph) keep their per-cell
+// state in CellLabels: the same epoch-stamped labels plus distances. Each
+// thread keeps one instance of every search state type (threadSearch) and
+// reuses its buffers across solves, with no heap allocation once warmed up.
+template <class Cost, template <class> class Frontier, class Heuristic = maze_core::NoHeuristic>
+using CoreSearch = maze_core::Search<maze_core::Four, Cost, BitGrid, Frontier, maze_core::EpochLabels<maze_core::Four>, Heuristic>;
+
+// Reads of a cell a side has not reached return the search's "unset" distance
+template <int Sides>
+using CellLabels = maze_core::DistanceLabels<int, maze_core::EpochLabels<maze_core::Four, Sides>>;
+
+template <class S>
+static S &threadSearch(){
+    static thread_local S search;
+    return search;
+}
+
+template <class Cost, template <class> class Frontier, class Heuristic = maze_core::NoHeuristic>
+static vector<Cell> solveCore(const MazeData &m, const Cost &cost){
+    ExpansionCounter expanded;
+    auto &search = threadSearch<CoreSearch<Cost, Frontier, Heuristic>>();
+    auto poll = [n = 0u](int, int) mutable { return (++n & 1023) != 0 || !stopRequested(); };
+    vector<Cell> path = search.template run<Cell>(BitGrid{&m.grid}, cost, m.sr, m.sc, m.er, m.ec, poll);
+    expanded.n = (long long)search.expanded();
+    return path;
+}
+
+template <template <class> class Frontier, class Heuristic = maze_core::NoHeuristic>
+static vector<Cell> solveByCost(const MazeData &m){
+    if (m.grid.weighted())
+        return solveCore<maze_core::ByteCost, Frontier, Heuristic>(m, maze_core::ByteCost{m.grid.weight, uint32_t(m.grid.maxCost)});
+    return solveCore<maze_core::UnitCost, Frontier, Heuristic>(m, maze_core::UnitCost{});
+}
+
+// Dijkstra (cost of entering each cell, 1 on plain mazes)
+static vector<Cell> solveDijkstra(const MazeData &m){ return solveByCost<maze_core::BinaryHeap>(m); }
+
+// Dijkstra with Dial's bucket queue. Entry costs are small integers (1..9), so
+// every tentative distance lies within maxCost of the current one and a ring
+// of maxCost+1 buckets replaces the binary heap: push and pop are O(1).
+static vector<Cell> solveDial(const MazeData &m){ return solveByCost<maze_core::Buckets>(m); }
+
+// BFS shortest path (in steps; terrain costs are ignored)
+static vector<Cell> solveBFS(const MazeData &m){ return solveCore<maze_core::UnitCost, maze_core::Fifo>(m, {}); }
+
+// One extra Dijkstra solve streamed to a trace file for --trace. Builds with
+// -DMAZE_NO_TRACE compile the hooks out and cannot write one.
+static bool traceDijkstra(const MazeData &m, const string &file){
+#ifdef MAZE_TRACE
+    maze_trace::TraceWriter trace(file, uint32_t(m.height), uint32_t(m.width));
+    if (!trace.isOpen()) { cerr << "Failed to write " << file << '\n'; return false; }
+    auto traced = [&](auto &search, const auto &cost){
+        search.setTrace(&trace);
+        search.template run<Cell>(BitGrid{&m.grid}, cost, m.sr, m.sc, m.er, m.ec);
+        search.setTrace(nullptr);
+    };
+    if (m.grid.weighted())
+        traced(threadSearch<CoreSearch<maze_core::ByteCost, maze_core::BinaryHeap>>(),
+               maze_core::ByteCost{m.grid.weight, uint32_t(m.grid.maxCost)});
+    else
+        traced(threadSearch<CoreSearch<maze_core::UnitCost, maze_core::BinaryHeap>>(), maze_core::UnitCost{});
+    if (!trace.close()) { cerr << "Failed to write " << file << '\n'; return false; }
+    cout << "Trace: " << trace.events() << " events, " << trace.bytes() << " bytes written to " << file << "\n";
+    return true;
+#else
+    (void)m;
+    cerr << "Cannot write " << file << ": this build has tracing compiled out (-DMAZE_NO_TRACE)\n";
+    return false;
+#endif
+}
+
+// Bit-parallel BFS: frontier and visited set are bitsets laid out exactly like
+// GridStorage::bits, so a whole level expands with word-wide shift/AND/OR.
+// Rows 0 and height+1 are wall padding, which keeps i-1, i+1 and i+-wordsPerRow
+// in range for every real row. Each frontier row also tracks the span of words
+// that may be non-zero, so thin frontiers only touch the words around them.
+// Instead of parents, each visited cell stores (level % 3) + 1 across two bit
+// planes; walking back from E to the neighbour whose code is one level lower
+// reproduces a shortest path.
+static inline uint64_t bitExpand(const uint64_t *F, size_t i, size_t wpr){
+    return F[i-wpr] | F[i+wpr] | (F[i]<<1) | (F[i-1]>>63) | (F[i]>>1) | (F[i+1]<<63);
+}
+
+static vector<Cell> solveBitBFS(const MazeData &m){
+    ExpansionCounter expanded;
+    const GridStorage &g = m.grid;
+    const int wpr = g.wordsPerRow;
+    const int H = m.height;
+    const uint64_t *O = g.bits;
+    vector<uint64_t> front(g.wordCount(), 0), next(g.wordCount(), 0);
+    vector<uint64_t> plane0(g.wordCount(), 0), plane1(g.wordCount(), 0);
+    // per padded row: first/last word that may be non-zero (empty when lo > hi)
+    vector<int> fLo(H + 2, wpr), fHi(H + 2, -1), nLo(H + 2, wpr), nHi(H + 2, -1);
+    auto bitAt = [&](const vector<uint64_t> &b, int r, int c){
+        size_t pr = size_t(r + 1), pc = size_t(c + 1);
+        return (b[pr * wpr + (pc >> 6)] >> (pc & 63)) & 1;
+    };
+    if (!g.open(m.sr, m.sc) || !g.open(m.er, m.ec)) return {};
+    {
+        const int pr = m.sr + 1, pc = m.sc + 1;
+        front[size_t(pr) * wpr + (pc >> 6)] |= uint64_t(1) << (pc & 63);
+        plane0[size_t(pr) * wpr + (pc >> 6)] |= uint64_t(1) << (pc & 63);
+        fLo[pr] = fHi[pr] = pc >> 6;
+    }
+
+    int lo = m.sr + 1, hi = m.sr + 1;         // padded rows holding the frontier
+    int stale[2] = {1, 0};                    // rows of `next` left over from two levels ago
+    int level = 0;
+    bool found = (m.sr == m.er && m.sc == m.ec);
+    while (!found) {
+        for (int r = stale[0]; r <= stale[1]; ++r) {
+            if (nLo[r] <= nHi[r]) fill(next.begin() + size_t(r) * wpr + nLo[r], next.begin() + size_t(r) * wpr + nHi[r] + 1, 0);
+            nLo[r] = wpr; nHi[r] = -1;
+        }
+        const int rlo = max(1, lo - 1), rhi = min(H, hi + 1);
+        const unsigned code = unsigned((level + 1) % 3) + 1;
+        int newLo = INT_MAX, newHi = -1;
+        for (int r = rlo; r <= rhi; ++r) {
+            int a = min(fLo[r - 1], min(fLo[r], fLo[r + 1]));
+            int b = max(fHi[r - 1], max(fHi[r], fHi[r + 1]));
+            if (a > b) continue;
+            a = max(0, a - 1); b = min(wpr - 1, b + 1);
+            const size_t row = size_t(r) * wpr;
+            int wlo = wpr, whi = -1;
+#ifdef __AVX2__
+            a &= ~3; b |= 3;                  // wordsPerRow is a multiple of 8
+            const uint64_t *F = front.data();
+            for (int w = a; w <= b; w += 4) {
+                const size_t i = row + w;
+                __m256i n = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(F + i - wpr)),
+                                            _mm256_loadu_si256((const __m256i*)(F + i + wpr)));
+                __m256i f = _mm256_loadu_si256((const __m256i*)(F + i));
+                n = _mm256_or_si256(n, _mm256_or_si256(_mm256_slli_epi64(f, 1), _mm256_srli_epi64(f, 1)));
+                n = _mm256_or_si256(n, _mm256_srli_epi64(_mm256_loadu_si256((const __m256i*)(F + i - 1)), 63));
+                n = _mm256_or_si256(n, _mm256_slli_epi64(_mm256_loadu_si256((const __m256i*)(F + i + 1)), 63));
+                __m256i seen = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(plane0.data() + i)),
+                                               _mm256_loadu_si256((const __m256i*)(plane1.data() + i)));
+                n = _mm256_andnot_si256(seen, _mm256_and_si256(n, _mm256_loadu_si256((const __m256i*)(O + i))));
+                if (_mm256_testz_si256(n, n)) continue;
+                _mm256_storeu_si256((__m256i*)(next.data() + i), n);
+                for (int j = 0; j < 4; ++j) if (next[i + j]) { wlo = min(wlo, w + j); whi = w + j; }
+            }
+#else
+            for (int w = a; w <= b; ++w) {
+                const size_t i = row + w;
+                const uint64_t n = bitExpand(front.data(), i, wpr) & O[i] & ~(plane0[i] | plane1[i]);
+                if (!n) continue;
+                next[i] = n; wlo = min(wlo, w); whi = w;
+            }
+#endif
+            if (whi < 0) continue;
+            nLo[r] = wlo; nHi[r] = whi;
+            newLo = min(newLo, r); newHi = r;
+            for (size_t i = row + wlo; i <= row + whi; ++i) {
+                expanded.n += bitset<64>(next[i]).count();
+                if (code & 1) plane0[i] |= next[i];
+                if (code & 2) plane1[i] |= next[i];
+            }
+        }
+        if (newHi < 0) return {};
+        ++level;
+        swap(front, next); swap(fLo, nLo); swap(fHi, nHi);
+        stale[0] = lo; stale[1] = hi;
+        lo = newLo; hi = newHi;
+        found = bitAt(front, m.er, m.ec);
+    }
+
+    auto codeAt = [&](int r, int c){ return unsigned(bitAt(plane0, r, c) | (bitAt(plane1, r, c) << 1)); };
+    vector<Cell> path(level + 1);
+    Cell at{m.er, m.ec};
+    for (int d = level; ; --d) {
+        path[d] = at;
+        if (d == 0) break;
+        const unsigned want = unsigned((d - 1) % 3) + 1;
+        const unsigned open = g.neighbors(at.row, at.col);
+        for (int k = 0; k < 4; ++k) {
+            if (!(open >> k & 1)) continue;
+            if (codeAt(at.row + DR[k], at.col + DC[k]) == want) { at = Cell{at.row + DR[k], at.col + DC[k]}; break; }
+        }
+    }
+    return path;
+}
+
+// State of the bidirectional searches: one stamp word holds both sides'
+// directions (side 0 grows from S, side 1 from E)
+struct BidirState {
+    CellLabels<2> cells;
+    vector<CellId> frontier[2], next;
+    maze_core::BinaryHeap<int> heap[2];
+};
+
+// Join two half-searches that met at `meet`: side 0 directions lead back to
+// S, side 1 directions lead forward to E
+static vector<Cell> stitchPath(const MazeData &m, CellId meet, const CellLabels<2> &cells){
+    const int W = m.width;
+    const CellId e = cellId(m.er, m.ec, W);
+    vector<Cell> path = traceDirections(meet, cellId(m.sr, m.sc, W), W, [&](CellId x){ return cells.direction(x, 0); });
+    size_t tail = 0;
+    for (CellId at = meet; at != e; ++tail) at -= DR[cells.direction(at, 1)] * W + DC[cells.direction(at, 1)];
+    path.reserve(path.size() + tail);
+    for (CellId at = meet; at != e;) {
+        at -= DR[cells.direction(at, 1)] * W + DC[cells.direction(at, 1)];
+        path.push_back(Cell{int(at / CellId(W)), int(at % CellId(W))});
+    }
+    return path;
+}
+
+// Bidirectional BFS: grows one level at a time from whichever side has the
+// smaller frontier. The level in which the searches first touch is finished
+// before stopping, so the best meeting point seen is a shortest connection.
+static vector<Cell> solveBidirBFS(const MazeData &m){
+    ExpansionCounter expanded;
+    const int W=m.width;
+    const CellId s=cellId(m.sr,m.sc,W), e=cellId(m.er,m.ec,W);
+    BidirState &st = threadSearch<BidirState>();
+    CellLabels<2> &ws = st.cells;
+    ws.begin(size_t(m.height)*W, -1);
+    vector<CellId> (&frontier)[2] = st.frontier;
+    vector<CellId> &next = st.next;
+    frontier[0].assign(1, s); frontier[1].assign(1, e);
+    ws.set(s, 0, 0, 0); ws.set(e, 0, 0, 1);
+    if (s==e) return {Cell{m.sr,m.sc}};
+    int best=INT_MAX;
+    CellId meet=NO_CELL;
+    while(meet==NO_CELL && !frontier[0].empty() && !frontier[1].empty()){
+        if(stopRequested()) return {};
+        const int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        next.clear();
+        expanded.n += frontier[side].size();
+        for(CellId u: frontier[side]){
+            const int r=int(u/CellId(W)), c=int(u%CellId(W));
+            const unsigned open=m.grid.neighbors(r,c);
+            for(int k=0;k<4;k++){
+                if(!(open>>k&1)) continue;
+                const CellId v=u+DR[k]*W+DC[k];
+                if(ws.dist(v, side)!=-1) continue;
+                const int dv=ws.dist(u, side)+1;
+                ws.set(v, dv, k, side); next.push_back(v);
+                const int other=ws.dist(v, side^1);
+                if(other!=-1 && dv+other<best){ best=dv+other; meet=v; }
+            }
+        }
+        frontier[side].swap(next);
+    }
+    if(meet==NO_CELL) return {};
+    return stitchPath(m, meet, ws);
+}
+
+// Bidirectional Dijkstra: alternates between the forward and backward heaps and
+// stops once the two smallest keys together can no longer beat the best
+// meeting cost found so far.
+static vector<Cell> solveBidirDijkstra(const MazeData &m){
+    ExpansionCounter expanded;
+    const int W=m.width;
+    const int INF=INT_MAX/4;
+    const CellId s=cellId(m.sr,m.sc,W), e=cellId(m.er,m.ec,W);
+    BidirState &st = threadSearch<BidirState>();
+    CellLabels<2> &ws = st.cells;
+    maze_core::BinaryHeap<int> (&heap)[2] = st.heap;
+    ws.begin(size_t(m.height)*W, INF);
+    heap[0].reset(); heap[1].reset();
+    ws.set(s, 0, 0, 0); heap[0].push(0, s);
+    ws.set(e, 0, 0, 1); heap[1].push(0, e);
+    int best = s==e ? 0 : INF;
+    CellId meet = s==e ? s : NO_CELL;
+    while(!heap[0].empty() && !heap[1].empty()){
+        if(heap[0].top().dist + heap[1].top().dist >= best) break;
+        const int side = heap[0].top().dist <= heap[1].top().dist ? 0 : 1;
+        const auto cur=heap[side].pop();
+        if(cur.dist!=ws.dist(cur.id, side)) continue;
+        if(expanded.expand()) return {};
+        const int r=int(cur.id/CellId(W)), c=int(cur.id%CellId(W));
+        const unsigned open=m.grid.neighbors(r,c);
+        for(int k=0;k<4;k++){
+            if(!(open>>k&1)) continue;
+            const CellId v=cur.id+DR[k]*W+DC[k];
+            // the backward search walks edges in reverse, so it pays for the cell it leaves
+            const int nd=cur.dist+(side==0 ? m.grid.cost(r+DR[k],c+DC[k]) : m.grid.cost(r,c));
+            if(nd<ws.dist(v, side)){ ws.set(v, nd, k, side); heap[side].push(nd, v); }
+            const int other=ws.dist(v, side^1);
+            if(other<INF && ws.dist(v, side)+other<best){ best=ws.dist(v, side)+other; meet=v; }
+        }
+    }
+    if(meet==NO_CELL) return {};
+    return stitchPath(m, meet, ws);
+}
+
+// Fixed set of worker threads for the parallel solvers. run(fn) calls fn(tid)
+// on every thread (the caller acts as thread 0) and returns once all are done.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) : count(max(1, threads)) {
+        for (int t = 1; t < count; ++t) workers.emplace_back([this, t]{ workerLoop(t); });
+    }
+    ~ThreadPool(){
+        { lock_guard<mutex> lk(mu); stop = true; }
+        wake.notify_all();
+        for (auto &w : workers) w.join();
+    }
+    int size() const { return count; }
+    void run(const function<void(int)> &fn){
+        {
+            lock_guard<mutex> lk(mu);
+            job = &fn; pending = count - 1; ++generation;
+        }
+        wake.notify_all();
+        fn(0);
+        unique_lock<mutex> lk(mu);
+        done.wait(lk, [this]{ return pending == 0; });
+        job = nullptr;
+    }
+private:
+    void workerLoop(int tid){
+        uint64_t seen = 0;
+        for (;;) {
+            const function<void(int)> *fn;
+            {
+                unique_lock<mutex> lk(mu);
+                wake.wait(lk, [&]{ return stop || generation != seen; });
+                if (stop) return;
+                seen = generation; fn = job;
+            }
+            (*fn)(tid);
+            lock_guard<mutex> lk(mu);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+    int count;
+    vector<thread> workers;
+    mutex mu;
+    condition_variable wake, done;
+    const function<void(int)> *job{};
+    uint64_t generation{};
+    int pending{};
+    bool stop{};
+};
+
+// Parallel level-synchronous BFS (direction-optimizing).
+// Cells are claimed with a CAS on a one-byte parent array: 0 = unvisited,
+// k+1 = reached by moving DR/DC[k] from the parent. Large top-down levels are
+// cut into chunks; each thread drains its own share of chunks and then steals
+// from the others' cursors. When the frontier grows past a fraction of the
+// unvisited cells the level is done bottom-up instead: every unvisited cell
+// looks for a parent in the frontier, which needs no CAS at all. Small levels
+// (the common case in corridor mazes) run inline on the calling thread.
+static vector<Cell> solveParallelBFS(const MazeData &m, ThreadPool &pool){
+    ExpansionCounter expanded;
+    const int H=m.height, W=m.width, T=pool.size();
+    const size_t N=size_t(H)*W;
+    const CellId s=cellId(m.sr,m.sc,W), e=cellId(m.er,m.ec,W);
+    const size_t CHUNK=256, SERIAL_LIMIT=2048;
+    const size_t ALPHA=14, BETA=24;           // Beamer et al. switching thresholds
+    vector<atomic<uint8_t>> parent(N);
+    for (auto &p : parent) p.store(0, memory_order_relaxed);
+    vector<uint8_t> inFrontier;               // only allocated once bottom-up is used
+    vector<vector<CellId>> local(T);
+    vector<CellId> frontier{s}, next;
+    size_t unvisited=0;
+    for (int r=0;r<H;r++) for (int c=0;c<W;c++) unvisited += m.grid.open(r,c);
+    parent[s].store(5, memory_order_relaxed); --unvisited;
+    bool bottomUp=false;
+
+    struct alignas(64) Cursor { atomic<size_t> next; size_t end; };
+    vector<Cursor> cursors(T);
+    // Hand out [0,n) in CHUNK pieces: own range first, then steal
+    auto forChunks = [&](int tid, const function<void(size_t,size_t)> &body){
+        for (int v=0; v<T; ++v) {
+            Cursor &cur = cursors[(tid+v)%T];
+            for (;;) {
+                const size_t b = cur.next.fetch_add(CHUNK, memory_order_relaxed);
+                if (b >= cur.end) break;
+                body(b, min(b+CHUNK, cur.end));
+            }
+        }
+    };
+    auto resetCursors = [&](size_t n){
+        for (int t=0;t<T;t++){ cursors[t].next.store(n*t/T, memory_order_relaxed); cursors[t].end=n*(t+1)/T; }
+    };
+    auto expandTopDown = [&](size_t b, size_t end, vector<CellId> &out){
+        for (size_t i=b;i<end;i++){
+            const CellId u=frontier[i];
+            const int r=int(u/CellId(W)), c=int(u%CellId(W));
+            const unsigned open=m.grid.neighbors(r,c);
+            for (int k=0;k<4;k++){
+                if(!(open>>k&1)) continue;
+                const CellId v=u+DR[k]*W+DC[k];
+                uint8_t expected=0;
+                if (parent[v].load(memory_order_relaxed)==0 &&
+                    parent[v].compare_exchange_strong(expected, uint8_t(k+1), memory_order_relaxed))
+                    out.push_back(v);
+            }
+        }
+    };
+    auto expandBottomUp = [&](size_t b, size_t end, vector<CellId> &out){
+        for (size_t v=b; v<end; v++){
+            if (parent[v].load(memory_order_relaxed)) continue;
+            const int r=int(v/W), c=int(v%W);
+            const unsigned open=m.grid.neighbors(r,c);
+            for (int k=0;k<4;k++){
+                if(!(open>>k&1)) continue;
+                if (inFrontier[CellId(v)+DR[k]*W+DC[k]]) {
+                    parent[v].store(uint8_t((k+2)%4+1), memory_order_relaxed);
+                    out.push_back(CellId(v)); break;
+                }
+            }
+        }
+    };
+
+    while (!frontier.empty() && !parent[e].load(memory_order_relaxed)) {
+        if (!bottomUp && frontier.size() > unvisited/ALPHA) bottomUp=true;
+        else if (bottomUp && frontier.size() < N/BETA) bottomUp=false;
+        expanded.n += frontier.size();
+        next.clear();
+        if (bottomUp) {
+            if (inFrontier.empty()) inFrontier.assign(N, 0);
+            for (CellId u: frontier) inFrontier[u]=1;
+            resetCursors(N);
+            pool.run([&](int tid){ local[tid].clear(); forChunks(tid, [&](size_t b, size_t end){ expandBottomUp(b, end, local[tid]); }); });
+            for (CellId u: frontier) inFrontier[u]=0;
+            for (auto &l: local) next.insert(next.end(), l.begin(), l.end());
+        } else if (frontier.size() <= SERIAL_LIMIT || T == 1) {
+            expandTopDown(0, frontier.size(), next);
+        } else {
+            resetCursors(frontier.size());
+            pool.run([&](int tid){ local[tid].clear(); forChunks(tid, [&](size_t b, size_t end){ expandTopDown(b, end, local[tid]); }); });
+            for (auto &l: local) next.insert(next.end(), l.begin(), l.end());
+        }
+        unvisited -= next.size();
+        frontier.swap(next);
+    }
+    if (!parent[e].load(memory_order_relaxed)) return {};
+    return traceDirections(e, s, W, [&](CellId at){ return parent[at].load(memory_order_relaxed)-1; });
+}
+
+// A*: Dijkstra ordered by f = g + Manhattan distance to E (heap key f, tie h).
+// Ties on f go to the node with the smaller h, i.e. the one closer to the goal, so on open areas
+// the search runs almost straight at E instead of flooding the whole f-layer.
+// Every cell costs at least 1, so the heuristic stays admissible on terrain.
+// It is maze_core::Search with the StepDistance heuristic.
+static inline int manhattan(int r, int c, int er, int ec){ return abs(r - er) + abs(c - ec); }
+
+static vector<Cell> solveAStar(const MazeData &m){ return solveByCost<maze_core::BinaryHeap, maze_core::StepDistance>(m); }
+
+// Jump Point Search for 4-connected uniform grids. Paths are kept canonical by
+// moving horizontally first: a horizontal jump probes vertically at every step
+// and stops where a vertical probe would find a jump point; a vertical jump only
+// stops at E, at a wall, or at a forced neighbour (a side cell that is open while
+// the cell behind it on that side is blocked). Everything in between is skipped,
+// so A* only ever sees the turning points of symmetric corridors and rooms.
+static CellId jumpVertical(const MazeData &m, int r, int c, int dr){
+    const GridStorage &g=m.grid;
+    for(;;){
+        r+=dr;
+        if(!g.open(r,c)) return NO_CELL;
+        if(r==m.er && c==m.ec) return cellId(r,c,m.width);
+        if((g.open(r,c-1) && !g.open(r-dr,c-1)) || (g.open(r,c+1) && !g.open(r-dr,c+1))) return cellId(r,c,m.width);
+    }
+}
+
+static CellId jumpHorizontal(const MazeData &m, int r, int c, int dc){
+    const GridStorage &g=m.grid;
+    for(;;){
+        c+=dc;
+        if(!g.open(r,c)) return NO_CELL;
+        if(r==m.er && c==m.ec) return cellId(r,c,m.width);
+        if(jumpVertical(m,r,c,-1)!=NO_CELL || jumpVertical(m,r,c,1)!=NO_CELL) return cellId(r,c,m.width);
+    }
+}
+
+// A* over jump points; heap keys are maze_core::tieKey(f, h)
+struct JpsState {
+    CellLabels<1> cells;
+    maze_core::BinaryHeap<uint64_t> heap;
+};
+
+static vector<Cell> solveJPS(const MazeData &m){
+    // Jumping relies on every step costing the same; terrain falls back to A*
+    if(m.grid.weighted()) return solveAStar(m);
+    ExpansionCounter expanded;
+    const int W=m.width;
+    const int INF=INT_MAX/4;
+    const CellId s=cellId(m.sr,m.sc,W), e=cellId(m.er,m.ec,W);
+    JpsState &st = threadSearch<JpsState>();
+    CellLabels<1> &ws = st.cells;               // direction = that of the jump that arrived
+    maze_core::BinaryHeap<uint64_t> &heap = st.heap;
+    ws.begin(size_t(m.height)*W, INF);
+    heap.reset();
+    const uint32_t h0=uint32_t(manhattan(m.sr,m.sc,m.er,m.ec));
+    ws.set(s, 0, 0); heap.push(maze_core::tieKey(h0, h0), s);
+    while(!heap.empty()){
+        const auto cur=heap.pop();
+        const CellId id=cur.id;
+        const int g=ws.dist(id);
+        if(int(uint32_t(cur.dist>>32) - uint32_t(cur.dist)) != g) continue;
+        if(expanded.expand()) return {};
+        if(id==e) break;
+        const int r=int(id/CellId(W)), c=int(id%CellId(W));
+        auto push=[&](CellId v, int k){
+            if(v==NO_CELL) return;
+            const int vr=int(v/CellId(W)), vc=int(v%CellId(W));
+            const int ng=g+abs(vr-r)+abs(vc-c);
+            if(ng<ws.dist(v)){
+                ws.set(v, ng, k);
+                const uint32_t h=uint32_t(manhattan(vr,vc,m.er,m.ec));
+                heap.push(maze_core::tieKey(uint32_t(ng)+h, h), v);
+            }
+        };
+        const int k=ws.direction(id);
+        if(id==s){
+            for(int d=0;d<4;d++) push(DR[d] ? jumpVertical(m,r,c,DR[d]) : jumpHorizontal(m,r,c,DC[d]), d);
+        } else if(DC[k]){
+            push(jumpHorizontal(m,r,c,DC[k]), k);
+            push(jumpVertical(m,r,c,-1), 0);
+            push(jumpVertical(m,r,c,1), 2);
+        } else {
+            const int dr=DR[k];
+            push(jumpVertical(m,r,c,dr), k);
+            if(m.grid.open(r,c-1) && !m.grid.open(r-dr,c-1)) push(jumpHorizontal(m,r,c,-1), 3);
+            if(m.grid.open(r,c+1) && !m.grid.open(r-dr,c+1)) push(jumpHorizontal(m,r,c,1), 1);
+        }
+    }
+    if(ws.dist(e)>=INF) return {};
+    // Jump points are joined by straight segments. Walk back cell by cell along
+    // the arrival direction, taking a cell's own direction wherever its g says
+    // it lies on the route (the jump's parent point, or an equally short join)
+    vector<Cell> path(size_t(ws.dist(e))+1);
+    CellId at=e;
+    for(int g=ws.dist(e), k=ws.direction(e);; --g){
+        path[g]=Cell{int(at/CellId(W)), int(at%CellId(W))};
+        if(at==s) break;
+        if(ws.dist(at)==g) k=ws.direction(at);
+        at-=DR[k]*W+DC[k];
+    }
+    return path;
+}
+
+// ---- Out-of-core BFS ------------------------------------------------------
+// For mazes whose per-cell search state does not fit in RAM. The grid itself
+// is only read (an mmapped .mzb is paged by the OS); the search state is one
+// byte per cell (0 = unvisited, k+1 = reached by moving DR/DC[k], 5 = start)
+// split into square tiles. Only `budget` bytes of tiles stay resident; the
+// rest are spilled to a scratch file and paged back on demand (clock/second-
+// chance eviction). The FIFO queue keeps its head and tail blocks in memory
+// and spills the middle to a second scratch file. The expansion order and
+// neighbour order are exactly those of solveBFS, so the path is identical.
+static FILE *openScratch(const string &path){
+    return path.empty() ? tmpfile() : fopen(path.c_str(), "w+b");
+}
+
+static bool seekScratch(FILE *f, uint64_t off){
+#ifdef _WIN32
+    return _fseeki64(f, (long long)off, SEEK_SET) == 0;
+#else
+    return fseeko(f, off_t(off), SEEK_SET) == 0;
+#endif
+}
+
+class TileCache {
+public:
+    static const int TILE = 256;               // tiles are TILE x TILE cells, 64 KB
+    TileCache(int height, int width, size_t budget, const string &scratchPath)
+        : tilesAcross((width + TILE - 1) / TILE),
+          slotOf(size_t((height + TILE - 1) / TILE) * tilesAcross, -1),
+          onDisk(slotOf.size(), 0),
+          file(openScratch(scratchPath)), path(scratchPath) {
+        const size_t n = max<size_t>(4, budget / (TILE * TILE));
+        slots.resize(min(n, slotOf.size()));
+        if (!file) throw runtime_error("cannot open tile scratch file");
+    }
+    ~TileCache(){ if (file) fclose(file); if (!path.empty()) remove(path.c_str()); }
+    TileCache(const TileCache&) = delete;
+    TileCache &operator=(const TileCache&) = delete;
+
+    uint8_t get(int r, int c){ return tileFor(r, c)[offsetIn(r, c)]; }
+    void set(int r, int c, uint8_t v){
+        uint8_t *t = tileFor(r, c);
+        t[offsetIn(r, c)] = v;
+        slots[lastSlot].dirty = true;
+    }
+private:
+    struct Slot { int tile{-1}; bool dirty{}, referenced{}; vector<uint8_t> data; };
+    static size_t offsetIn(int r, int c){ return size_t(r % TILE) * TILE + (c % TILE); }
+    uint8_t *tileFor(int r, int c){
+        const int tile = (r / TILE) * tilesAcross + (c / TILE);
+        if (tile != lastTile) {
+            int s = slotOf[tile];
+            if (s < 0) s = load(tile);
+            slots[s].referenced = true;
+            lastTile = tile; lastSlot = s;
+        }
+        return slots[lastSlot].data.data();
+    }
+    int load(int tile){
+        // clock sweep: skip (and clear) recently used slots once
+        for (;;) {
+            Slot &cand = slots[hand];
+            if (cand.tile < 0 || !cand.referenced) break;
+            cand.referenced = false;
+            hand = (hand + 1) % slots.size();
+        }
+        const int s = int(hand);
+        hand = (hand + 1) % slots.size();
+        Slot &slot = slots[s];
+        if (slot.tile >= 0) {
+            if (slot.dirty) {
+                seekScratch(file, uint64_t(slot.tile) * TILE * TILE);
+                fwrite(slot.data.data(), 1, slot.data.size(), file);
+                onDisk[slot.tile] = 1;
+            }
+            slotOf[slot.tile] = -1;
+        }
+        slot.data.resize(size_t(TILE) * TILE);
+        if (onDisk[tile]) {
+            seekScratch(file, uint64_t(tile) * TILE * TILE);
+            if (fread(slot.data.data(), 1, slot.data.size(), file) != slot.data.size()) throw runtime_error("tile scratch read failed");
+        } else {
+            fill(slot.data.begin(), slot.data.end(), 0);
+        }
+        slot.tile = tile; slot.dirty = false;
+        slotOf[tile] = s;
+        return s;
+    }
+    int tilesAcross;
+    vector<int> slotOf;
+    vector<uint8_t> onDisk;
+    vector<Slot> slots;
+    FILE *file;
+    string path;
+    size_t hand{};
+    int lastTile{-1}, lastSlot{-1};
+};
+
+class ExternalQueue {
+public:
+    static const size_t BLOCK = 1 << 16;       // cells per spilled block
+    explicit ExternalQueue(const string &scratchPath) : file(nullptr), path(scratchPath) {}
+    ~ExternalQueue(){ if (file) { fclose(file); if (!path.empty()) remove(path.c_str()); } }
+    ExternalQueue(const ExternalQueue&) = delete;
+    ExternalQueue &operator=(const ExternalQueue&) = delete;
+    static size_t memoryBytes(){ return 2 * BLOCK * sizeof(uint64_t); }
+
+    bool empty() const { return headPos == head.size() && readOff == writeOff && tail.empty(); }
+    void push(uint64_t v){
+        tail.push_back(v);
+        if (tail.size() < BLOCK) return;
+        if (!file && !(file = openScratch(path))) throw runtime_error("cannot open queue scratch file");
+        seekScratch(file, writeOff);
+        fwrite(tail.data(), sizeof(uint64_t), tail.size(), file);
+        writeOff += tail.size() * sizeof(uint64_t);
+        tail.clear();
+    }
+    uint64_t pop(){
+        if (headPos == head.size()) {
+            headPos = 0;
+            if (readOff < writeOff) {
+                head.resize(BLOCK);
+                seekScratch(file, readOff);
+                if (fread(head.data(), sizeof(uint64_t), BLOCK, file) != BLOCK) throw runtime_error("queue scratch read failed");
+                readOff += BLOCK * sizeof(uint64_t);
+                if (readOff == writeOff) readOff = writeOff = 0;   // file drained, reuse it
+            } else {
+                head.swap(tail); tail.clear();
+            }
+        }
+        return head[headPos++];
+    }
+private:
+    FILE *file;
+    string path;
+    vector<uint64_t> head, tail;
+    size_t headPos{};
+    uint64_t readOff{}, writeOff{};
+};
+
+struct OutOfCoreOptions {
+    size_t budgetBytes = size_t(256) << 20;
+    string scratchDir;                         // empty = anonymous tmpfile()
+};
+
+static vector<Cell> solveOutOfCoreBFS(const MazeData &m, const OutOfCoreOptions &opt){
+    ExpansionCounter expanded;
+    const uint64_t W = uint64_t(m.width);
+    const size_t tileBudget = opt.budgetBytes > ExternalQueue::memoryBytes() ? opt.budgetBytes - ExternalQueue::memoryBytes() : 0;
+    TileCache state(m.height, m.width, tileBudget, opt.scratchDir.empty() ? "" : opt.scratchDir + "/bfs_tiles.scratch");
+    ExternalQueue q(opt.scratchDir.empty() ? "" : opt.scratchDir + "/bfs_queue.scratch");
+    const uint64_t s = uint64_t(m.sr) * W + m.sc, e = uint64_t(m.er) * W + m.ec;
+    state.set(m.sr, m.sc, 5); q.push(s);
+    while(!q.empty()){
+        const uint64_t u = q.pop(); ++expanded.n;
+        if(u == e) break;
+        const int r = int(u / W), c = int(u % W);
+        const unsigned open = m.grid.neighbors(r,c);
+        for(int k=0;k<4;k++){
+            if(!(open>>k&1)) continue;
+            const int nr=r+DR[k], nc=c+DC[k];
+            if(state.get(nr,nc)) continue;
+            state.set(nr,nc,uint8_t(k+1)); q.push(uint64_t(nr)*W+nc);
+        }
+    }
+    if(!state.get(m.er,m.ec)) return {};
+    vector<Cell> path;
+    for(Cell at{m.er,m.ec};;){
+        path.push_back(at);
+        const int k = state.get(at.row,at.col) - 1;
+        if(k == 4) break;
+        at = Cell{at.row-DR[k], at.col-DC[k]};
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// FNV-1a over the grid, so cached indexes can tell they belong to this maze
+static uint64_t hashGrid(const MazeData &m){
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&](uint64_t v){ h = (h ^ v) * 1099511628211ULL; };
+    mix(uint64_t(m.height)); mix(uint64_t(m.width));
+    for (size_t i = 0; i < m.grid.wordCount(); ++i) mix(m.grid.bits[i]);
+    if (m.grid.weighted()) for (size_t i = 0; i < size_t(m.height) * m.width; ++i) mix(m.grid.weight[i]);
+    return h;
+}
+
+// Checks for indexes read back from disk: bytes left in the file, and CSR
+// offsets that start at 0, never decrease and end at the edge count
+static uint64_t bytesLeft(ifstream &in){
+    const streampos at = in.tellg();
+    in.seekg(0, ios::end);
+    const streampos end = in.tellg();
+    in.seekg(at);
+    return at < 0 || end < at ? 0 : uint64_t(end - at);
+}
+
+static bool validCsr(const vector<int> &start, uint64_t nedges){
+    if (start.empty() || start.front() != 0 || uint64_t(start.back()) != nedges) return false;
+    for (size_t i = 1; i < start.size(); ++i) if (start[i] < start[i - 1]) return false;
+    return true;
+}
+
+// ---- Hierarchical pathfinding (HPA*) ---------------------------------------
+// The grid is cut into K x K clusters. Wherever two neighbouring clusters share
+// a run of open border cells we place entrances (one in the middle of short
+// runs, one at each end of long ones); each entrance is a pair of abstract
+// nodes joined by an inter-cluster edge. Intra-cluster edges hold the exact
+// in-cluster distance between every pair of entrances of a cluster. A query
+// only searches inside the S and E clusters to hook them up, runs A* on the
+// small abstract graph, and refines each abstract edge back into cells with
+// another in-cluster search. Paths are near-optimal (routes are restricted to
+// entrance cells), and query cost depends on the abstract graph, not on area.
+struct HpaEdge { int to, cost; };
+
+class HpaIndex {
+public:
+    int K{};
+    bool build(const MazeData &m, int clusterSize);
+    bool save(const string &path) const;
+    bool load(const string &path, const MazeData &m);
+    size_t nodeCount() const { return cells.size(); }
+    vector<Cell> query(const MazeData &m, int sr, int sc, int er, int ec) const;
+private:
+    int height{}, width{}, clustersAcross{};
+    uint64_t fingerprint{};
+    vector<uint64_t> cells;                   // abstract node -> cell id (r*width+c)
+    vector<int> edgeStart;                    // CSR offsets, size nodes+1
+    vector<HpaEdge> edges;
+
+    int clusterOf(int r, int c) const { return (r / K) * clustersAcross + (c / K); }
+    // Dijkstra limited to one cluster. Forward: dist = cost from src to each
+    // cell. Reverse: dist = cost from each cell to src. dir = direction each
+    // cell was reached by. Indexed locally.
+    void clusterSearch(const MazeData &m, int src, bool reverseDir, vector<int> &dist, vector<uint8_t> &dir) const;
+    void appendRefined(const MazeData &m, int from, int to, vector<Cell> &path) const;
+};
+
+void HpaIndex::clusterSearch(const MazeData &m, int src, bool reverseDir, vector<int> &dist, vector<uint8_t> &dir) const {
+    ExpansionCounter expanded;
+    const int W = m.width, INF = INT_MAX / 4;
+    const int sr = src / W, sc = src % W;
+    const int r0 = sr / K * K, c0 = sc / K * K;
+    const int r1 = min(m.height, r0 + K), c1 = min(m.width, c0 + K);
+    auto local = [&](int r, int c){ return (r - r0) * K + (c - c0); };
+    dist.assign(size_t(K) * K, INF); dir.assign(size_t(K) * K, 0);
+    typedef pair<int,int> Node;
+    priority_queue<Node, vector<Node>, greater<Node>> pq;
+    dist[local(sr, sc)] = 0; pq.push({0, src});
+    while (!pq.empty()) {
+        auto cur = pq.top(); pq.pop();
+        const int r = cur.second / W, c = cur.second % W;
+        if (cur.first != dist[local(r, c)]) continue;
+        ++expanded.n;
+        const unsigned open = m.grid.neighbors(r, c);
+        for (int k = 0; k < 4; k++) {
+            if (!(open >> k & 1)) continue;
+            const int nr = r + DR[k], nc = c + DC[k];
+            if (nr < r0 || nr >= r1 || nc < c0 || nc >= c1) continue;
+            const int nd = cur.first + (reverseDir ? m.grid.cost(r, c) : m.grid.cost(nr, nc));
+            if (nd < dist[local(nr, nc)]) { dist[local(nr, nc)] = nd; dir[local(nr, nc)] = uint8_t(k); pq.push({nd, nr * W + nc}); }
+        }
+    }
+}
+
+bool HpaIndex::build(const MazeData &m, int clusterSize){
+    K = max(2, clusterSize);
+    height = m.height; width = m.width;
+    clustersAcross = (width + K - 1) / K;
+    fingerprint = hashGrid(m);
+    const int W = width;
+    unordered_map<uint64_t,int> nodeOf;
+    vector<vector<HpaEdge>> adj;
+    auto node = [&](int r, int c){
+        const uint64_t id = uint64_t(r) * W + c;
+        auto it = nodeOf.find(id);
+        if (it != nodeOf.end()) return it->second;
+        nodeOf.emplace(id, int(cells.size()));
+        cells.push_back(id); adj.emplace_back();
+        return int(cells.size()) - 1;
+    };
+    auto link = [&](int ar, int ac, int br, int bc){
+        const int a = node(ar, ac), b = node(br, bc);
+        adj[a].push_back({b, m.grid.cost(br, bc)});
+        adj[b].push_back({a, m.grid.cost(ar, ac)});
+    };
+    // Entrances along one border: cells (r,c) and (r+dr,c+dc) for each step
+    auto scanBorder = [&](int r, int c, int dr, int dc, int stepR, int stepC, int len){
+        int runStart = -1;
+        for (int i = 0; i <= len; ++i) {
+            const bool both = i < len && m.grid.open(r + i * stepR, c + i * stepC) && m.grid.open(r + i * stepR + dr, c + i * stepC + dc);
+            if (both && runStart < 0) runStart = i;
+            if (both || runStart < 0) continue;
+            const int runEnd = i - 1;
+            if (runEnd - runStart + 1 < 6) {
+                const int mid = (runStart + runEnd) / 2;
+                link(r + mid * stepR, c + mid * stepC, r + mid * stepR + dr, c + mid * stepC + dc);
+            } else {
+                link(r + runStart * stepR, c + runStart * stepC, r + runStart * stepR + dr, c + runStart * stepC + dc);
+                link(r + runEnd * stepR, c + runEnd * stepC, r + runEnd * stepR + dr, c + runEnd * stepC + dc);
+            }
+            runStart = -1;
+        }
+    };
+    for (int r0 = 0; r0 < height; r0 += K) for (int c0 = 0; c0 < width; c0 += K) {
+        const int rows = min(K, height - r0), cols = min(K, width - c0);
+        if (c0 + K < width) scanBorder(r0, c0 + K - 1, 0, 1, 1, 0, rows);    // east border
+        if (r0 + K < height) scanBorder(r0 + K - 1, c0, 1, 0, 0, 1, cols);   // south border
+    }
+    // Intra-cluster edges between every pair of entrances sharing a cluster
+    unordered_map<int, vector<int>> byCluster;
+    for (int i = 0; i < int(cells.size()); ++i) byCluster[clusterOf(int(cells[i] / W), int(cells[i] % W))].push_back(i);
+    vector<int> dist;
+    vector<uint8_t> dir;
+    for (auto &kv : byCluster) {
+        for (int a : kv.second) {
+            clusterSearch(m, int(cells[a]), false, dist, dir);
+            const int ar = int(cells[a] / W), ac = int(cells[a] % W);
+            for (int b : kv.second) {
+                if (a == b) continue;
+                const int br = int(cells[b] / W), bc = int(cells[b] % W);
+                const int d = dist[(br - ar / K * K) * K + (bc - ac / K * K)];
+                if (d < INT_MAX / 4) adj[a].push_back({b, d});
+            }
+        }
+    }
+    edgeStart.assign(cells.size() + 1, 0);
+    edges.clear();
+    for (size_t i = 0; i < adj.size(); ++i) { edgeStart[i] = int(edges.size()); edges.insert(edges.end(), adj[i].begin(), adj[i].end()); }
+    edgeStart[adj.size()] = int(edges.size());
+    return true;
+}
+
+// Index file: "HPA1", K, height, width, grid fingerprint, node count, edge
+// count, then the node cells, CSR offsets and edges as raw little-endian arrays
+bool HpaIndex::save(const string &path) const {
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) return false;
+    const uint64_t nodes = cells.size(), nedges = edges.size();
+    const int32_t dims[3] = {K, height, width};
+    out.write("HPA1", 4);
+    out.write(reinterpret_cast<const char*>(dims), sizeof dims);
+    out.write(reinterpret_cast<const char*>(&fingerprint), 8);
+    out.write(reinterpret_cast<const char*>(&nodes), 8);
+    out.write(reinterpret_cast<const char*>(&nedges), 8);
+    out.write(reinterpret_cast<const char*>(cells.data()), streamsize(nodes * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char*>(edgeStart.data()), streamsize((nodes + 1) * sizeof(int)));
+    out.write(reinterpret_cast<const char*>(edges.data()), streamsize(nedges * sizeof(HpaEdge)));
+    return bool(out);
+}
+
+bool HpaIndex::load(const string &path, const MazeData &m){
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    char magic[4];
+    int32_t dims[3];
+    uint64_t fp = 0, nodes = 0, nedges = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(dims), sizeof dims);
+    in.read(reinterpret_cast<char*>(&fp), 8);
+    in.read(reinterpret_cast<char*>(&nodes), 8);
+    in.read(reinterpret_cast<char*>(&nedges), 8);
+    if (!in || memcmp(magic, "HPA1", 4) != 0 || dims[1] != m.height || dims[2] != m.width || fp != hashGrid(m)) return false;
+    // every node is a distinct cell, and the arrays must fill the rest of the file exactly
+    const uint64_t N = uint64_t(m.height) * m.width;
+    if (dims[0] < 2 || nodes > N || nedges > INT_MAX ||
+        bytesLeft(in) != nodes * sizeof(uint64_t) + (nodes + 1) * sizeof(int) + nedges * sizeof(HpaEdge)) return false;
+    K = dims[0]; height = dims[1]; width = dims[2]; fingerprint = fp;
+    clustersAcross = (width + K - 1) / K;
+    cells.resize(nodes); edgeStart.resize(nodes + 1); edges.resize(nedges);
+    in.read(reinterpret_cast<char*>(cells.data()), streamsize(nodes * sizeof(uint64_t)));
+    in.read(reinterpret_cast<char*>(edgeStart.data()), streamsize((nodes + 1) * sizeof(int)));
+    in.read(reinterpret_cast<char*>(edges.data()), streamsize(nedges * sizeof(HpaEdge)));
+    bool ok = bool(in) && validCsr(edgeStart, nedges);
+    for (size_t i = 0; ok && i < cells.size(); ++i) ok = cells[i] < N;
+    for (size_t i = 0; ok && i < edges.size(); ++i) ok = edges[i].to >= 0 && uint64_t(edges[i].to) < nodes && edges[i].cost >= 0;
+    if (!ok) { cells.clear(); edgeStart.clear(); edges.clear(); K = 0; }
+    return ok;
+}
+
+// Append the in-cluster route from cell `from` to cell `to` (excluding `from`)
+void HpaIndex::appendRefined(const MazeData &m, int from, int to, vector<Cell> &path) const {
+    const int W = m.width;
+    if (abs(from / W - to / W) + abs(from % W - to % W) == 1 && clusterOf(from / W, from % W) != clusterOf(to / W, to % W)) {
+        path.push_back(Cell{to / W, to % W});
+        return;
+    }
+    vector<int> dist;
+    vector<uint8_t> dir;
+    clusterSearch(m, from, false, dist, dir);
+    const int r0 = from / W / K * K, c0 = from % W / K * K;
+    const vector<Cell> seg = traceDirections(to, from, W, [&](int at){ return dir[(at / W - r0) * K + (at % W - c0)]; });
+    path.insert(path.end(), seg.begin() + 1, seg.end());
+}
+
+vector<Cell> HpaIndex::query(const MazeData &m, int sr, int sc, int er, int ec) const {
+    ExpansionCounter expanded;
+    const int W = m.width, INF = INT_MAX / 4;
+    const int N = int(cells.size()), S = N, E = N + 1;
+    const int s = sr * W + sc, e = er * W + ec;
+    if (!m.grid.open(sr, sc) || !m.grid.open(er, ec)) return {};
+    if (s == e) return {Cell{sr, sc}};
+    // Hook S and E into the abstract graph with searches inside their clusters
+    const int cs = clusterOf(sr, sc), ce = clusterOf(er, ec);
+    vector<HpaEdge> fromS;
+    unordered_map<int,int> toE;
+    vector<int> dist;
+    vector<uint8_t> dir;
+    auto localIdx = [&](int cell, int ref){ return (cell / W - ref / W / K * K) * K + (cell % W - ref % W / K * K); };
+    clusterSearch(m, s, false, dist, dir);
+    int direct = INF;
+    if (cs == ce) direct = dist[localIdx(e, s)];
+    for (int i = 0; i < N; ++i) {
+        const int cell = int(cells[i]);
+        if (clusterOf(cell / W, cell % W) == cs && dist[localIdx(cell, s)] < INF) fromS.push_back({i, dist[localIdx(cell, s)]});
+    }
+    clusterSearch(m, e, true, dist, dir);
+    for (int i = 0; i < N; ++i) {
+        const int cell = int(cells[i]);
+        if (clusterOf(cell / W, cell % W) == ce && dist[localIdx(cell, e)] < INF) toE[i] = dist[localIdx(cell, e)];
+    }
+    // A* over entrances plus the two temporary endpoints
+    auto cellOf = [&](int v){ return v == S ? s : v == E ? e : int(cells[v]); };
+    auto h = [&](int v){ const int c = cellOf(v); return abs(c / W - er) + abs(c % W - ec); };
+    vector<int> g(N + 2, INF), from(N + 2, -1);
+    struct Node { int f, h, v; bool operator>(const Node &o) const { return f != o.f ? f > o.f : h > o.h; } };
+    priority_queue<Node, vector<Node>, greater<Node>> pq;
+    g[S] = 0; pq.push({h(S), h(S), S});
+    if (direct < INF) { g[E] = direct; from[E] = S; pq.push({direct, 0, E}); }
+    auto relax = [&](int u, int v, int w){
+        if (g[u] + w < g[v]) { g[v] = g[u] + w; from[v] = u; pq.push({g[v] + h(v), h(v), v}); }
+    };
+    while (!pq.empty()) {
+        auto cur = pq.top(); pq.pop();
+        if (cur.f - cur.h != g[cur.v]) continue;
+        ++expanded.n;
+        if (cur.v == E) break;
+        if (cur.v == S) { for (auto &ed : fromS) relax(S, ed.to, ed.cost); continue; }
+        for (int i = edgeStart[cur.v]; i < edgeStart[cur.v + 1]; ++i) relax(cur.v, edges[i].to, edges[i].cost);
+        auto it = toE.find(cur.v);
+        if (it != toE.end()) relax(cur.v, E, it->second);
+    }
+    if (g[E] >= INF) return {};
+    vector<int> route;
+    for (int v = E; v != -1; v = from[v]) route.push_back(cellOf(v));
+    reverse(route.begin(), route.end());
+    vector<Cell> path{Cell{sr, sc}};
+    for (size_t i = 1; i < route.size(); ++i) {
+        if (route[i] == route[i - 1]) continue;   // S or E sitting on an entrance
+        appendRefined(m, route[i - 1], route[i], path);
+    }
+    return path;
+}
+
+// ---- Junction graph (corridor contraction) ----------------------------------
+// Most open cells of a perfect maze are corridor cells with exactly two open
+// neighbours. The junction graph keeps only junctions, dead ends, S and E as
+// nodes and replaces each corridor between two of them with one weighted edge
+// (cost = sum of entered cells, len = steps, dir = first move), stored CSR.
+// Searches run over the nodes and expand the winning edges back into cells by
+// re-walking the corridors, so no cell lists are stored. With dead-end filling,
+// dead ends other than S and E are removed repeatedly first; on a perfect maze
+// that leaves just the solution corridor. The filled graph depends on S/E and
+// keeps a bitset of the surviving cells, since a corridor cell may then have
+// filled side branches.
+struct JunctionEdge { int to, cost, len, dir; };
+
+class JunctionGraph {
+public:
+    bool build(const MazeData &m, bool fillDeadEnds);
+    bool save(const string &path) const;
+    bool load(const string &path, const MazeData &m, bool fillDeadEnds);
+    size_t nodeCount() const { return cells.size(); }
+    size_t edgeCount() const { return edges.size(); }
+    vector<Cell> solve(const MazeData &m) const;
+private:
+    int height{}, width{}, sr{}, sc{}, er{}, ec{};
+    bool filled{};
+    uint64_t fingerprint{};
+    vector<int> cells;                        // node -> cell id (r*width+c), ascending
+    vector<int> edgeStart;                    // CSR offsets, size nodes+1
+    vector<JunctionEdge> edges;
+    vector<uint64_t> keep;                    // surviving cells when filled
+
+    unsigned passable(const MazeData &m, int r, int c) const {
+        unsigned open = m.grid.neighbors(r, c);
+        if (!filled) return open;
+        for (int k = 0; k < 4; ++k) {
+            const size_t v = size_t(r + DR[k]) * width + (c + DC[k]);
+            if (open >> k & 1 && !(keep[v >> 6] >> (v & 63) & 1)) open &= ~(1u << k);
+        }
+        return open;
+    }
+    bool isNode(const MazeData &m, int r, int c) const {
+        return bitset<4>(passable(m, r, c)).count() != 2 || (r == sr && c == sc) || (r == er && c == ec);
+    }
+    // Follow the corridor leaving cell `from` by move `dir` for `len` steps,
+    // calling visit(cell id) on every cell entered
+    template <class Visit>
+    void walk(const MazeData &m, int from, int dir, int len, Visit visit) const {
+        int r = from / width, c = from % width;
+        for (int i = 0; i < len; ++i) {
+            r += DR[dir]; c += DC[dir];
+            visit(r * width + c);
+            const unsigned open = passable(m, r, c) & ~(1u << ((dir + 2) & 3));
+            if (open) dir = __builtin_ctz(open);
+        }
+    }
+};
+
+bool JunctionGraph::build(const MazeData &m, bool fillDeadEnds){
+    height = m.height; width = m.width;
+    sr = m.sr; sc = m.sc; er = m.er; ec = m.ec;
+    filled = fillDeadEnds;
+    fingerprint = hashGrid(m);
+    const int W = width;
+    const size_t N = size_t(height) * W;
+    cells.clear(); edgeStart.clear(); edges.clear(); keep.clear();
+    if (!m.grid.open(sr, sc) || !m.grid.open(er, ec)) return false;
+    if (filled) {
+        keep.assign((N + 63) / 64, 0);
+        vector<uint8_t> deg(N, 0);
+        vector<int> stack;
+        for (int r = 0; r < height; ++r)
+            for (int c = 0; c < W; ++c) {
+                if (!m.grid.open(r, c)) continue;
+                const size_t i = size_t(r) * W + c;
+                keep[i >> 6] |= uint64_t(1) << (i & 63);
+                deg[i] = uint8_t(bitset<4>(m.grid.neighbors(r, c)).count());
+                if (deg[i] <= 1 && int(i) != sr * W + sc && int(i) != er * W + ec) stack.push_back(int(i));
+            }
+        while (!stack.empty()) {
+            const int u = stack.back(); stack.pop_back();
+            keep[size_t(u) >> 6] &= ~(uint64_t(1) << (u & 63));
+            const unsigned open = m.grid.neighbors(u / W, u % W);
+            for (int k = 0; k < 4; ++k) {
+                if (!(open >> k & 1)) continue;
+                const int v = u + DR[k] * W + DC[k];
+                if (!(keep[size_t(v) >> 6] >> (v & 63) & 1)) continue;
+                if (--deg[v] == 1 && v != sr * W + sc && v != er * W + ec) stack.push_back(v);
+            }
+        }
+    }
+    for (int r = 0; r < height; ++r)
+        for (int c = 0; c < W; ++c) {
+            if (!m.grid.open(r, c)) continue;
+            if (filled && !(keep[(size_t(r) * W + c) >> 6] >> ((size_t(r) * W + c) & 63) & 1)) continue;
+            if (isNode(m, r, c)) cells.push_back(r * W + c);
+        }
+    edgeStart.push_back(0);
+    for (const int u : cells) {
+        const unsigned open = passable(m, u / W, u % W);
+        for (int k = 0; k < 4; ++k) {
+            if (!(open >> k & 1)) continue;
+            // walk until the next node, summing the entered cells' costs
+            int r = u / W + DR[k], c = u % W + DC[k], dir = k, len = 1, cost = m.grid.cost(r, c);
+            bool dead = false;
+            while (!isNode(m, r, c)) {
+                const unsigned next = passable(m, r, c) & ~(1u << ((dir + 2) & 3));
+                if (!next) { dead = true; break; }
+                dir = __builtin_ctz(next);
+                r += DR[dir]; c += DC[dir];
+                ++len; cost += m.grid.cost(r, c);
+            }
+            const int v = int(lower_bound(cells.begin(), cells.end(), r * W + c) - cells.begin());
+            if (!dead && cells[v] != u) edges.push_back({v, cost, len, k});
+        }
+        edgeStart.push_back(int(edges.size()));
+    }
+    return true;
+}
+
+// Dijkstra over the nodes: per-node labels, the edge each node was reached by
+struct GraphState {
+    CellLabels<1> nodes;
+    vector<int> via, route;
+    maze_core::BinaryHeap<int> heap;
+};
+
+vector<Cell> JunctionGraph::solve(const MazeData &m) const {
+    ExpansionCounter expanded;
+    const int W = width, INF = INT_MAX / 4;
+    if (cells.empty() || m.height != height || m.width != width) return {};
+    const int s = int(lower_bound(cells.begin(), cells.end(), m.sr * W + m.sc) - cells.begin());
+    const int e = int(lower_bound(cells.begin(), cells.end(), m.er * W + m.ec) - cells.begin());
+    // S and E are nodes of the graph built for them; any other pair is not
+    if (s == int(cells.size()) || cells[s] != m.sr * W + m.sc || e == int(cells.size()) || cells[e] != m.er * W + m.ec) return {};
+    GraphState &st = threadSearch<GraphState>();
+    CellLabels<1> &ws = st.nodes;
+    vector<int> &via = st.via;
+    ws.begin(cells.size(), INF);
+    if (via.size() < cells.size()) via.resize(cells.size());
+    st.heap.reset();
+    ws.set(s, 0, 0); via[s] = -1; st.heap.push(0, uint32_t(s));
+    while (!st.heap.empty()) {
+        const auto cur = st.heap.pop();
+        const int u = int(cur.id);
+        if (cur.dist != ws.dist(u)) continue;
+        ++expanded.n;
+        if (u == e) break;
+        for (int i = edgeStart[u]; i < edgeStart[u + 1]; ++i) {
+            const JunctionEdge &ed = edges[i];
+            const int nd = cur.dist + ed.cost;
+            if (nd < ws.dist(ed.to)) { ws.set(ed.to, nd, 0); via[ed.to] = i; st.heap.push(nd, uint32_t(ed.to)); }
+        }
+    }
+    if (ws.dist(e) >= INF) return {};
+    // Edges back from E, then their corridors forward from S
+    size_t steps = 0;
+    vector<int> &route = st.route; route.clear();
+    for (int v = e; via[v] != -1;) {
+        const int i = via[v];
+        route.push_back(i);
+        steps += size_t(edges[i].len);
+        v = int(upper_bound(edgeStart.begin(), edgeStart.end(), i) - edgeStart.begin()) - 1;
+    }
+    vector<Cell> path;
+    path.reserve(steps + 1);
+    path.push_back(Cell{m.sr, m.sc});
+    for (size_t j = route.size(); j-- > 0;) {
+        const int i = route[j];
+        const int u = int(upper_bound(edgeStart.begin(), edgeStart.end(), i) - edgeStart.begin()) - 1;
+        walk(m, cells[u], edges[i].dir, edges[i].len, [&](int at){ path.push_back(Cell{at / W, at % W}); });
+    }
+    return path;
+}
+
+bool JunctionGraph::save(const string &path) const {
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) return false;
+    const uint64_t nodes = cells.size(), nedges = edges.size(), nkeep = keep.size();
+    const int32_t dims[7] = {height, width, sr, sc, er, ec, filled};
+    out.write("JGR1", 4);
+    out.write(reinterpret_cast<const char*>(dims), sizeof dims);
+    out.write(reinterpret_cast<const char*>(&fingerprint), 8);
+    out.write(reinterpret_cast<const char*>(&nodes), 8);
+    out.write(reinterpret_cast<const char*>(&nedges), 8);
+    out.write(reinterpret_cast<const char*>(&nkeep), 8);
+    out.write(reinterpret_cast<const char*>(cells.data()), streamsize(nodes * sizeof(int)));
+    out.write(reinterpret_cast<const char*>(edgeStart.data()), streamsize((nodes + 1) * sizeof(int)));
+    out.write(reinterpret_cast<const char*>(edges.data()), streamsize(nedges * sizeof(JunctionEdge)));
+    out.write(reinterpret_cast<const char*>(keep.data()), streamsize(nkeep * sizeof(uint64_t)));
+    return bool(out);
+}
+
+bool JunctionGraph::load(const string &path, const MazeData &m, bool fillDeadEnds){
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    char magic[4];
+    int32_t dims[7];
+    uint64_t fp = 0, nodes = 0, nedges = 0, nkeep = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(dims), sizeof dims);
+    in.read(reinterpret_cast<char*>(&fp), 8);
+    in.read(reinterpret_cast<char*>(&nodes), 8);
+    in.read(reinterpret_cast<char*>(&nedges), 8);
+    in.read(reinterpret_cast<char*>(&nkeep), 8);
+    if (!in || memcmp(magic, "JGR1", 4) != 0 || dims[0] != m.height || dims[1] != m.width || fp != hashGrid(m)) return false;
+    // S and E are always nodes (and fix the filling), so a graph only serves the S/E it was built for
+    if (dims[6] != int(fillDeadEnds) || dims[2] != m.sr || dims[3] != m.sc || dims[4] != m.er || dims[5] != m.ec) return false;
+    const uint64_t N = uint64_t(m.height) * m.width;
+    if (nodes > N || nedges > 4 * nodes || nkeep != (fillDeadEnds ? (N + 63) / 64 : 0) ||
+        bytesLeft(in) != nodes * sizeof(int) + (nodes + 1) * sizeof(int) + nedges * sizeof(JunctionEdge) + nkeep * sizeof(uint64_t)) return false;
+    height = dims[0]; width = dims[1]; sr = dims[2]; sc = dims[3]; er = dims[4]; ec = dims[5];
+    filled = dims[6] != 0; fingerprint = fp;
+    cells.resize(nodes); edgeStart.resize(nodes + 1); edges.resize(nedges); keep.resize(nkeep);
+    in.read(reinterpret_cast<char*>(cells.data()), streamsize(nodes * sizeof(int)));
+    in.read(reinterpret_cast<char*>(edgeStart.data()), streamsize((nodes + 1) * sizeof(int)));
+    in.read(reinterpret_cast<char*>(edges.data()), streamsize(nedges * sizeof(JunctionEdge)));
+    in.read(reinterpret_cast<char*>(keep.data()), streamsize(nkeep * sizeof(uint64_t)));
+    bool ok = bool(in) && validCsr(edgeStart, nedges);
+    for (size_t i = 0; ok && i < cells.size(); ++i) ok = cells[i] >= 0 && uint64_t(cells[i]) < N && (i == 0 || cells[i] > cells[i - 1]);
+    for (size_t i = 0; ok && i < edges.size(); ++i)
+        ok = edges[i].to >= 0 && uint64_t(edges[i].to) < nodes && edges[i].len >= 1 && edges[i].cost >= 0 && edges[i].dir >= 0 && edges[i].dir < 4;
+    if (!ok) { cells.clear(); edgeStart.clear(); edges.clear(); keep.clear(); }
+    return ok;
+}
+
+// ---- Dynamic mazes (LPA*) -------------------------------------------------------
+// DynamicMaze is an editable copy of a maze. Toggling a cell patches its open
+// bit and the neighbour masks of the cell and its four neighbours in place, so
+// maze() stays a valid MazeData for every other solver without a rebuild.
+// Edited cells are queued until the planner drains them.
+class DynamicMaze {
+public:
+    explicit DynamicMaze(const MazeData &src) : m(src),
+        bits(src.grid.bits, src.grid.bits + src.grid.wordCount()),
+        nbr(src.grid.nbr, src.grid.nbr + (size_t(src.height) * src.width + 1) / 2) {
+        if (src.grid.weighted()) weight.assign(src.grid.weight, src.grid.weight + size_t(src.height) * src.width);
+        m.grid.bits = bits.data(); m.grid.nbr = nbr.data();
+        m.grid.weight = weight.empty() ? nullptr : weight.data();
+        m.grid.backing.reset();
+    }
+    DynamicMaze(const DynamicMaze&) = delete;
+    DynamicMaze &operator=(const DynamicMaze&) = delete;
+
+    const MazeData &maze() const { return m; }
+    bool open(int r, int c) const { return m.grid.open(r, c); }
+    void setOpen(int r, int c, bool open);
+    void toggle(int r, int c){ setOpen(r, c, !open(r, c)); }
+    // Moves the cells edited since the last call into `out`
+    void drainChanges(vector<int> &out){ out.swap(changed); changed.clear(); }
+
+private:
+    MazeData m;
+    vector<uint64_t> bits;
+    vector<uint8_t> nbr, weight;
+    vector<int> changed;
+
+    void refreshMask(int r, int c){
+        unsigned mask = 0;
+        if (m.grid.open(r, c)) for (int k = 0; k < 4; ++k) mask |= unsigned(m.grid.open(r + DR[k], c + DC[k])) << k;
+        const size_t i = size_t(r) * m.width + c;
+        const unsigned shift = (i & 1) * 4;
+        nbr[i >> 1] = uint8_t((nbr[i >> 1] & ~(0xFu << shift)) | mask << shift);
+    }
+};
+
+void DynamicMaze::setOpen(int r, int c, bool open){
+    if (m.grid.open(r, c) == open) return;
+    const size_t pr = size_t(r + 1), pc = size_t(c + 1);
+    uint64_t &word = bits[pr * m.grid.wordsPerRow + (pc >> 6)];
+    word ^= uint64_t(1) << (pc & 63);
+    refreshMask(r, c);
+    for (int k = 0; k < 4; ++k) {
+        const int nr = r + DR[k], nc = c + DC[k];
+        if (nr >= 0 && nr < m.height && nc >= 0 && nc < m.width) refreshMask(nr, nc);
+    }
+    changed.push_back(r * m.width + c);
+}
+
+// Lifelong Planning A* from S to E over a DynamicMaze. g and rhs (the one-step
+// lookahead min over neighbours of g + entry cost) persist between solves, so
+// after a batch of edits only the edited cells and their neighbours are
+// re-queued and the search re-expands just the region whose distances the
+// edits changed. Keys are [min(g,rhs) + h, min(g,rhs)] with the Manhattan
+// heuristic; outdated heap entries are skipped on pop rather than removed.
+struct HeapNode {
+    int key, tie, id;           // ordered by key, then tie
+    bool operator>(const HeapNode &o) const { return key != o.key ? key > o.key : tie > o.tie; }
+};
+
+class LpaPlanner {
+public:
+    explicit LpaPlanner(DynamicMaze &maze) : dm(maze) {
+        const MazeData &m = dm.maze();
+        W = m.width; s = m.sr * W + m.sc; e = m.er * W + m.ec;
+        g.assign(size_t(m.height) * W, INF);
+        rhs.assign(size_t(m.height) * W, INF);
+        rhs[s] = 0;
+        heap.push_back(key(s));
+    }
+    // Applies the pending edits, repairs the distances and returns S -> E
+    vector<Cell> solve();
+
+private:
+    static constexpr int INF = INT_MAX / 4;
+    DynamicMaze &dm;
+    int W{}, s{}, e{};
+    vector<int> g, rhs, changes;
+    vector<HeapNode> heap;
+
+    HeapNode key(int v) const {
+        const int k = min(g[v], rhs[v]);
+        if (k >= INF) return {INF, INF, v};
+        return {k + manhattan(v / W, v % W, e / W, e % W), k, v};
+    }
+    void update(int v);
+    // update() for v and every in-bounds neighbour: their rhs may read g[v]
+    void updateAround(int v){
+        const MazeData &m = dm.maze();
+        const int r = v / W, c = v % W;
+        update(v);
+        for (int k = 0; k < 4; ++k) {
+            const int nr = r + DR[k], nc = c + DC[k];
+            if (nr >= 0 && nr < m.height && nc >= 0 && nc < W) update(nr * W + nc);
+        }
+    }
+    void repair();
+};
+
+void LpaPlanner::update(int v){
+    const GridStorage &grid = dm.maze().grid;
+    if (v != s) {
+        const int r = v / W, c = v % W;
+        const unsigned open = grid.neighbors(r, c);
+        int best = INF;
+        for (int k = 0; k < 4; ++k) if (open >> k & 1) best = min(best, g[v + DR[k] * W + DC[k]]);
+        rhs[v] = best >= INF ? INF : best + grid.cost(r, c);
+    }
+    if (g[v] != rhs[v]) {
+        heap.push_back(key(v));
+        push_heap(heap.begin(), heap.end(), greater<HeapNode>());
+    }
+}
+
+void LpaPlanner::repair(){
+    ExpansionCounter expanded;
+    for (;;) {
+        while (!heap.empty()) {
+            const HeapNode &t = heap.front();
+            const HeapNode now = key(t.id);
+            if (g[t.id] != rhs[t.id] && t.key == now.key && t.tie == now.tie) break;
+            pop_heap(heap.begin(), heap.end(), greater<HeapNode>());
+            heap.pop_back();
+        }
+        if (heap.empty()) break;
+        if (!(key(e) > heap.front()) && g[e] == rhs[e]) break;
+        const int u = heap.front().id;
+        pop_heap(heap.begin(), heap.end(), greater<HeapNode>());
+        heap.pop_back();
+        ++expanded.n;
+        if (g[u] > rhs[u]) {
+            g[u] = rhs[u];                   // overconsistent: settle, as Dijkstra would
+            const MazeData &m = dm.maze();
+            const int r = u / W, c = u % W;
+            for (int k = 0; k < 4; ++k) {
+                const int nr = r + DR[k], nc = c + DC[k];
+                if (nr >= 0 && nr < m.height && nc >= 0 && nc < W) update(nr * W + nc);
+            }
+        } else {
+            g[u] = INF;                      // underconsistent: invalidate and re-derive
+            updateAround(u);
+        }
+    }
+}
+
+vector<Cell> LpaPlanner::solve(){
+    dm.drainChanges(changes);
+    for (const int v : changes) updateAround(v);
+    repair();
+    const GridStorage &grid = dm.maze().grid;
+    if (g[e] >= INF || !grid.open(s / W, s % W) || !grid.open(e / W, e % W)) return {};
+    // Back from E along strictly decreasing g
+    vector<Cell> path;
+    for (int v = e;;) {
+        path.push_back(Cell{v / W, v % W});
+        if (v == s) break;
+        const unsigned open = grid.neighbors(v / W, v % W);
+        int best = -1;
+        for (int k = 0; k < 4; ++k) {
+            if (!(open >> k & 1)) continue;
+            const int u = v + DR[k] * W + DC[k];
+            if (best < 0 || g[u] < g[best]) best = u;
+        }
+        if (best < 0 || g[best] >= g[v]) return {};
+        v = best;
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// Replay benchmark for the incremental planner: `edits` random toggles of
+// cells other than S and E, applied `perBatch` at a time. After every batch
+// LPA* repairs its search and solveDijkstra solves the edited maze from
+// scratch; both answers must cost the same.
+static bool runReplan(const MazeData &m, int edits, int perBatch){
+    DynamicMaze dm(m);
+    LpaPlanner lpa(dm);
+    cellsExpanded = 0;
+    auto t0 = chrono::steady_clock::now();
+    const vector<Cell> initial = lpa.solve();
+    auto t1 = chrono::steady_clock::now();
+    cout << "LPA* initial plan: " << fixed << setprecision(3) << chrono::duration<double, milli>(t1 - t0).count()
+         << " ms, " << cellsExpanded.exchange(0) << " cells expanded, path length " << initial.size() << "\n";
+
+    mt19937 rng(12345u);
+    long long lpaNs = 0, dijNs = 0, lpaExpanded = 0, dijExpanded = 0;
+    int batches = 0, unreachable = 0, mismatches = 0;
+    for (int done = 0; done < edits; ++batches) {
+        for (int i = 0; i < perBatch && done < edits; ++i, ++done) {
+            int r, c;
+            do { r = int(rng() % m.height); c = int(rng() % m.width); }
+            while ((r == m.sr && c == m.sc) || (r == m.er && c == m.ec));
+            dm.toggle(r, c);
+        }
+        auto a0 = chrono::steady_clock::now();
+        const vector<Cell> incremental = lpa.solve();
+        auto a1 = chrono::steady_clock::now();
+        lpaExpanded += cellsExpanded.exchange(0);
+        const vector<Cell> scratch = solveDijkstra(dm.maze());
+        auto a2 = chrono::steady_clock::now();
+        dijExpanded += cellsExpanded.exchange(0);
+        lpaNs += chrono::duration_cast<chrono::nanoseconds>(a1 - a0).count();
+        dijNs += chrono::duration_cast<chrono::nanoseconds>(a2 - a1).count();
+        if (scratch.empty()) ++unreachable;
+        if (incremental.empty() != scratch.empty() ||
+            (!scratch.empty() && pathCost(dm.maze(), incremental) != pathCost(dm.maze(), scratch))) ++mismatches;
+    }
+    const double n = max(1, batches);
+    cout << "Replan: " << edits << " edits in " << batches << " batches of " << perBatch
+         << " (" << unreachable << " left E unreachable)\n";
+    cout << "  LPA* repair:       " << setprecision(4) << lpaNs / 1e6 / n << " ms/batch, "
+         << setprecision(0) << lpaExpanded / n << " cells expanded/batch\n";
+    cout << "  Dijkstra (scratch): " << setprecision(4) << dijNs / 1e6 / n << " ms/batch, "
+         << setprecision(0) << dijExpanded / n << " cells expanded/batch\n";
+    cout << "  Speedup: " << setprecision(2) << double(dijNs) / max<long long>(1, lpaNs) << "x, cost mismatches: " << mismatches << "\n";
+    return mismatches == 0;
+}
+
+// ---- Batch queries -----------------------------------------------------------
+// Answers many (start, end) pairs against one maze. Queries are grouped by the
+// endpoint they share (ends, or starts if there are fewer distinct starts);
+// each group costs one distance-field search from the shared cell, after which
+// every query in the group is answered by walking down the field from its
+// other endpoint. N queries thus cost one search per distinct shared endpoint.
+struct BatchQuery { int sr, sc, er, ec; };
+
+static const char MOVE_CHARS[4] = {'U','R','D','L'};
+
+// Dial search over the whole maze from `src`. Forward: dist = cost src -> cell.
+// Reverse: dist = cost cell -> src (a step pays for the cell it enters).
+static void computeDistanceField(const MazeData &m, int src, bool reverseDir, vector<int> &dist, vector<vector<int>> &buckets){
+    const int W=m.width, INF=INT_MAX/4;
+    const int B=m.grid.maxCost+1;
+    dist.assign(size_t(m.height)*W, INF);
+    buckets.resize(B);
+    for(auto &b: buckets) b.clear();
+    dist[src]=0; buckets[0].push_back(src);
+    size_t pending=1;
+    for(int d=0; pending>0; ++d){
+        vector<int> &bucket=buckets[d%B];
+        for(size_t i=0;i<bucket.size();++i){
+            const int u=bucket[i];
+            if(dist[u]!=d) continue;
+            const int r=u/W, c=u%W;
+            const unsigned open=m.grid.neighbors(r,c);
+            for(int k=0;k<4;k++){
+                if(!(open>>k&1)) continue;
+                const int nr=r+DR[k], nc=c+DC[k], v=nr*W+nc;
+                const int nd=d+(reverseDir ? m.grid.cost(r,c) : m.grid.cost(nr,nc));
+                if(nd<dist[v]){ dist[v]=nd; buckets[nd%B].push_back(v); ++pending; }
+            }
+        }
+        pending-=bucket.size();
+        bucket.clear();
+    }
+}
+
+// Answer every query and write one line per query, in input order:
+//   sr sc er ec cost moves      (moves: one of U/R/D/L per step, '-' if empty)
+//   sr sc er ec -1              (unreachable)
+static bool runBatch(const MazeData &m, const string &queryPath, const string &outPath){
+    ifstream in(queryPath);
+    if(!in.is_open()){ cerr << "Failed to read " << queryPath << '\n'; return false; }
+    vector<BatchQuery> queries;
+    string line;
+    while(getline(in, line)){
+        if(line.empty() || line[0]=='#') continue;
+        BatchQuery q;
+        if(sscanf(line.c_str(), "%d %d %d %d", &q.sr, &q.sc, &q.er, &q.ec)!=4) continue;
+        if(q.sr<0||q.sr>=m.height||q.sc<0||q.sc>=m.width||q.er<0||q.er>=m.height||q.ec<0||q.ec>=m.width){
+            cerr << "Skipping out-of-range query: " << line << '\n'; continue;
+        }
+        queries.push_back(q);
+    }
+    const int W=m.width, INF=INT_MAX/4;
+    unordered_map<int, vector<int>> byStart, byEnd;
+    for(int i=0;i<(int)queries.size();++i){
+        byStart[queries[i].sr*W+queries[i].sc].push_back(i);
+        byEnd[queries[i].er*W+queries[i].ec].push_back(i);
+    }
+    const bool groupByEnd = byEnd.size() <= byStart.size();
+    const auto &groups = groupByEnd ? byEnd : byStart;
+
+    auto t0 = chrono::steady_clock::now();
+    vector<string> answers(queries.size());
+    vector<int> dist;
+    vector<vector<int>> buckets;
+    string moves;
+    for(const auto &grp: groups){
+        const int root=grp.first;
+        computeDistanceField(m, root, groupByEnd, dist, buckets);
+        for(int qi: grp.second){
+            const BatchQuery &q=queries[qi];
+            const int other = groupByEnd ? q.sr*W+q.sc : q.er*W+q.ec;
+            string &ans=answers[qi];
+            ans = to_string(q.sr)+" "+to_string(q.sc)+" "+to_string(q.er)+" "+to_string(q.ec)+" ";
+            if(!m.grid.open(q.sr,q.sc) || !m.grid.open(q.er,q.ec) || dist[other]>=INF){ ans += "-1"; continue; }
+            // Walk from the far endpoint down the field to the root
+            moves.clear();
+            for(int at=other; at!=root;){
+                const int r=at/W, c=at%W;
+                const unsigned open=m.grid.neighbors(r,c);
+                for(int k=0;k<4;k++){
+                    if(!(open>>k&1)) continue;
+                    const int v=(r+DR[k])*W+(c+DC[k]);
+                    const int step = groupByEnd ? m.grid.cost(r+DR[k],c+DC[k]) : m.grid.cost(r,c);
+                    if(dist[v]==dist[at]-step){ moves.push_back(groupByEnd ? MOVE_CHARS[k] : MOVE_CHARS[(k+2)%4]); at=v; break; }
+                }
+            }
+            if(!groupByEnd) reverse(moves.begin(), moves.end());
+            ans += to_string(dist[other]) + " " + (moves.empty() ? string("-") : moves);
+        }
+    }
+    auto t1 = chrono::steady_clock::now();
+
+    ofstream out(outPath);
+    if(!out.is_open()){ cerr << "Failed to write " << outPath << '\n'; return false; }
+    for(const auto &a: answers) out << a << '\n';
+    const double ms = chrono::duration<double, milli>(t1-t0).count();
+    cout << "Batch: " << queries.size() << " queries, " << groups.size() << " distance fields (grouped by "
+         << (groupByEnd ? "end" : "start") << "), " << fixed << setprecision(2) << ms << " ms total, "
+         << (queries.empty() ? 0.0 : ms / queries.size()) << " ms/query\n";
+    cout << "Answers written to " << outPath << '\n';
+    return true;
+}
+
+// DFS (stack) - may not be shortest
+static vector<Cell> solveDFS(const MazeData &m){ return solveCore<maze_core::UnitCost, maze_core::Lifo>(m, {}); }
+
+// Right-hand wall follower (MazeSequentialIterator.cpp without the drawing):
+// at every step try right, forward, left, back relative to the heading. Needs
+// no per-cell state; the returned walk includes dead-end backtracking and is
+// empty when E is not reached within 4 * cells steps (E off the wall S follows).
+static vector<Cell> solveWallFollower(const MazeData &m){
+    ExpansionCounter expanded;
+    int r=m.sr, c=m.sc;
+    unsigned open=m.grid.open(r,c) ? m.grid.neighbors(r,c) : 0;
+    int dir=1;                                // east unless another side is first open
+    for(int k=0;k<4;k++) if(open>>k&1){ dir=k; break; }
+    vector<Cell> walk{Cell{r,c}};
+    const long long maxSteps=4LL*m.height*m.width;
+    for(long long step=0; !(r==m.er && c==m.ec); ++step){
+        if(step>=maxSteps || !open) return {};
+        if(expanded.expand()) return {};
+        for(int t: {1, 0, 3, 2}){
+            const int k=(dir+t)&3;
+            if(!(open>>k&1)) continue;
+            r+=DR[k]; c+=DC[k]; dir=k;
+            break;
+        }
+        walk.push_back(Cell{r,c});
+        open=m.grid.neighbors(r,c);
+    }
+    return walk;
+}
+
+// Raster sweep: computes the full distance field from S with alternating
+// forward (top-to-bottom) and backward (bottom-to-top) row passes. Each row
+// keeps a dirty column span; a pass only visits rows with a non-empty span,
+// pulls in the vertical neighbours over that span, then runs a left-to-right
+// and a right-to-left scan that keep going past the span only while cells
+// still improve. Changed columns dirty the rows above and below, so the row
+// below is handled later in the same pass and the row above in the next one.
+// Scan order is fixed, which keeps the result deterministic. The path is
+// read back by descending the distance field from E.
+// The sweep reads whole rows through raw pointers, so it keeps a dense field
+// instead of stamped labels; assign() reuses the capacity
+struct SweepState { vector<int> field, spanLo, spanHi; };
+
+static vector<Cell> solveSweep(const MazeData &m){
+    ExpansionCounter expanded;
+    const int H=m.height,W=m.width;
+    const int INF=INT_MAX/4;
+    const GridStorage &g=m.grid;
+    SweepState &st = threadSearch<SweepState>();
+    vector<int> &dist=st.field; dist.assign(size_t(H)*W, INF);
+    vector<int> &spanLo=st.spanLo, &spanHi=st.spanHi;   // dirty columns per row
+    spanLo.assign(H, W); spanHi.assign(H, -1);
+    int dirtyLo=H, dirtyHi=-1;                 // rows that may have a dirty span
+    auto markRow=[&](int r, int lo, int hi){
+        if(r<0 || r>=H) return;
+        spanLo[r]=min(spanLo[r],lo); spanHi[r]=max(spanHi[r],hi);
+        dirtyLo=min(dirtyLo,r); dirtyHi=max(dirtyHi,r);
+    };
+    dist[size_t(m.sr)*W+m.sc]=0;
+    for(int r=m.sr-1;r<=m.sr+1;r++) markRow(r,m.sc,m.sc);
+    auto relaxRow=[&](int r){
+        int a=spanLo[r], b=spanHi[r];
+        spanLo[r]=W; spanHi[r]=-1;
+        expanded.n += b-a+1;                  // dirty cells re-examined
+        int *D=&dist[size_t(r)*W];
+        int lo=W, hi=-1;                      // columns that improved
+        for(int c=a;c<=b;c++){
+            const unsigned open=g.neighbors(r,c);
+            for(int k=0;k<4;k+=2) if(open>>k&1){
+                const int nd=dist[size_t(r+DR[k])*W+c]+g.cost(r,c);
+                if(nd<D[c]){ D[c]=nd; lo=min(lo,c); hi=max(hi,c); }
+            }
+        }
+        for(int c=max(a,1);c<W;c++){
+            if(!(g.neighbors(r,c)>>3&1)) { if(c>b) break; continue; }
+            const int nd=D[c-1]+g.cost(r,c);
+            if(nd<D[c]){ D[c]=nd; lo=min(lo,c); hi=max(hi,c); }
+            else if(c>b) break;
+        }
+        for(int c=min(max(b,hi),W-2);c>=0;c--){
+            if(!(g.neighbors(r,c)>>1&1)) { if(c<a) break; continue; }
+            const int nd=D[c+1]+g.cost(r,c);
+            if(nd<D[c]){ D[c]=nd; lo=min(lo,c); hi=max(hi,c); }
+            else if(c<a) break;
+        }
+        if(hi<0) return;
+        markRow(r-1,lo,hi); markRow(r+1,lo,hi);
+    };
+    for(bool forward=true; dirtyLo<=dirtyHi; forward=!forward){
+        const int lo=dirtyLo, hi=dirtyHi;
+        dirtyLo=H; dirtyHi=-1;
+        // rows dirtied ahead of the sweep are picked up by this same pass
+        if(forward){ for(int r=lo; r<=max(hi,dirtyHi); r++) if(spanLo[r]<=spanHi[r]) relaxRow(r); }
+        else       { for(int r=hi; r>=min(lo,dirtyLo); r--) if(spanLo[r]<=spanHi[r]) relaxRow(r); }
+    }
+    if(dist[size_t(m.er)*W+m.ec]>=INF) return {};
+    vector<Cell> path;
+    Cell at{m.er,m.ec};
+    for(;;){
+        path.push_back(at);
+        if(at.row==m.sr && at.col==m.sc) break;
+        const int d=dist[size_t(at.row)*W+at.col]-g.cost(at.row,at.col);
+        const unsigned open=g.neighbors(at.row,at.col);
+        for(int k=0;k<4;k++){
+            if(!(open>>k&1)) continue;
+            if(dist[size_t(at.row+DR[k])*W+at.col+DC[k]]==d){ at=Cell{at.row+DR[k],at.col+DC[k]}; break; }
+        }
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+// ---- Solver daemon -------------------------------------------------------
+// --serve SOCKET keeps parsed mazes (and their HPA* indexes, built on first
+// use) resident and answers solve requests over a Unix domain socket. Mazes
+// sit in an LRU cache keyed by path + mtime + size, so an edited maze file is
+// reloaded on the next request. Connections are served by a fixed set of
+// worker threads; each connection may send any number of requests.
+//
+// Wire format (little-endian, must match client.cpp):
+//   request : SolveRequest, then pathLen bytes of maze path
+//   response: SolveResponse, then (steps+3)/4 bytes of moves, 2 bits each
+//             (DR/DC index, lowest bits first)
+// A negative sr/er in the request means "use the maze's own S / E".
+static const uint32_t REQUEST_MAGIC = 0x51525a4d;   // "MZRQ"
+static const uint32_t RESPONSE_MAGIC = 0x53525a4d;  // "MZRS"
+
+enum SolveAlgo : uint8_t { ALGO_BFS, ALGO_DIJKSTRA, ALGO_ASTAR, ALGO_JPS, ALGO_DIAL, ALGO_BIDIR_BFS, ALGO_HPA, ALGO_BIT_BFS, ALGO_COUNT };
+enum SolveStatus : int32_t { STATUS_OK, STATUS_NO_PATH, STATUS_LOAD_FAILED, STATUS_BAD_REQUEST };
+
+struct SolveRequest {
+    uint32_t magic;
+    uint8_t algo, reserved[3];
+    int32_t sr, sc, er, ec;
+    uint32_t pathLen;
+};
+struct SolveResponse {
+    uint32_t magic;
+    int32_t status;
+    int32_t sr, sc;
+    uint64_t solveNanos;
+    int64_t cost;
+    uint32_t steps, reserved;
+};
+
+struct CachedMaze {
+    MazeData maze;
+    mutex hpaMu;
+    unique_ptr<HpaIndex> hpa;
+    const HpaIndex &index(){
+        lock_guard<mutex> lk(hpaMu);
+        if (!hpa) { hpa.reset(new HpaIndex()); hpa->build(maze, 16); }
+        return *hpa;
+    }
+};
+
+class MazeCache {
+public:
+    explicit MazeCache(size_t capacity) : cap(max<size_t>(1, capacity)) {}
+    shared_ptr<CachedMaze> get(const string &path){
+#ifdef _WIN32
+        const string key = path;
+#else
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) return nullptr;
+        const string key = path + "|" + to_string((long long)st.st_mtime) + "|" + to_string((long long)st.st_size);
+#endif
+        {
+            lock_guard<mutex> lk(mu);
+            auto it = index.find(key);
+            if (it != index.end()) { order.splice(order.begin(), order, it->second); return it->second->second; }
+        }
+        // Load outside the lock; a racing duplicate load is harmless
+        auto entry = make_shared<CachedMaze>();
+        if (!loadMaze(path, entry->maze)) return nullptr;
+        lock_guard<mutex> lk(mu);
+        auto it = index.find(key);
+        if (it != index.end()) return it->second->second;
+        order.emplace_front(key, entry);
+        index[key] = order.begin();
+        while (order.size() > cap) { index.erase(order.back().first); order.pop_back(); }
+        return entry;
+    }
+private:
+    size_t cap;
+    mutex mu;
+    list<pair<string, shared_ptr<CachedMaze>>> order;   // most recently used first
+    unordered_map<string, list<pair<string, shared_ptr<CachedMaze>>>::iterator> index;
+};
+
+static vector<Cell> solveWith(uint8_t algo, CachedMaze &cm, const MazeData &m){
+    switch (algo) {
+        case ALGO_BFS: return solveBFS(m);
+        case ALGO_DIJKSTRA: return solveDijkstra(m);
+        case ALGO_ASTAR: return solveAStar(m);
+        case ALGO_JPS: return solveJPS(m);
+        case ALGO_DIAL: return solveDial(m);
+        case ALGO_BIDIR_BFS: return solveBidirBFS(m);
+        case ALGO_HPA: return cm.index().query(m, m.sr, m.sc, m.er, m.ec);
+        case ALGO_BIT_BFS: return solveBitBFS(m);
+    }
+    return {};
+}
+
+#ifndef _WIN32
+static bool readFull(int fd, void *buf, size_t n){
+    char *p = static_cast<char*>(buf);
+    while (n > 0) {
+        const ssize_t got = ::read(fd, p, n);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got; n -= size_t(got);
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void *buf, size_t n){
+    const char *p = static_cast<const char*>(buf);
+    while (n > 0) {
+        const ssize_t put = ::write(fd, p, n);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put; n -= size_t(put);
+    }
+    return true;
+}
+
+static void serveConnection(int fd, MazeCache &cache){
+    SolveRequest req;
+    string path;
+    vector<uint8_t> packed;
+    while (readFull(fd, &req, sizeof req)) {
+        SolveResponse resp{};
+        resp.magic = RESPONSE_MAGIC;
+        if (req.magic != REQUEST_MAGIC || req.pathLen == 0 || req.pathLen > 4096) {
+            resp.status = STATUS_BAD_REQUEST;
+            writeFull(fd, &resp, sizeof resp);
+            break;
+        }
+        path.resize(req.pathLen);
+        if (!readFull(fd, &path[0], req.pathLen)) break;
+        packed.clear();
+        auto entry = cache.get(path);
+        if (!entry) resp.status = STATUS_LOAD_FAILED;
+        else {
+            // Solvers read S/E from MazeData; the copy shares the grid storage
+            MazeData m = entry->maze;
+            if (req.sr >= 0) { m.sr = req.sr; m.sc = req.sc; }
+            if (req.er >= 0) { m.er = req.er; m.ec = req.ec; }
+            resp.sr = m.sr; resp.sc = m.sc;
+            if (req.algo >= ALGO_COUNT || m.sr >= m.height || m.sc < 0 || m.sc >= m.width ||
+                m.er >= m.height || m.ec < 0 || m.ec >= m.width ||
+                !m.grid.open(m.sr, m.sc) || !m.grid.open(m.er, m.ec)) resp.status = STATUS_BAD_REQUEST;
+            else {
+                auto t0 = chrono::steady_clock::now();
+                vector<Cell> path2 = solveWith(req.algo, *entry, m);
+                auto t1 = chrono::steady_clock::now();
+                resp.solveNanos = uint64_t(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+                if (path2.empty()) resp.status = STATUS_NO_PATH;
+                else {
+                    resp.status = STATUS_OK;
+                    resp.cost = pathCost(m, path2);
+                    resp.steps = uint32_t(path2.size() - 1);
+                    packed.assign((resp.steps + 3) / 4, 0);
+                    for (uint32_t i = 0; i < resp.steps; ++i) {
+                        const int dr = path2[i + 1].row - path2[i].row, dc = path2[i + 1].col - path2[i].col;
+                        const int k = dr < 0 ? 0 : dc > 0 ? 1 : dr > 0 ? 2 : 3;
+                        packed[i / 4] |= uint8_t(k << ((i % 4) * 2));
+                    }
+                }
+            }
+        }
+        if (!writeFull(fd, &resp, sizeof resp) || !writeFull(fd, packed.data(), packed.size())) break;
+    }
+    ::close(fd);
+}
+
+static int runServer(const string &socketPath, int threads, size_t cacheSize){
+    signal(SIGPIPE, SIG_IGN);
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) { perror("socket"); return 1; }
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof addr.sun_path) { cerr << "Socket path too long\n"; return 1; }
+    strcpy(addr.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0 || listen(listener, 128) != 0) {
+        perror("bind/listen"); return 1;
+    }
+    MazeCache cache(cacheSize);
+    mutex mu;
+    condition_variable ready;
+    deque<int> pendingConns;
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) workers.emplace_back([&]{
+        for (;;) {
+            int fd;
+            {
+                unique_lock<mutex> lk(mu);
+                ready.wait(lk, [&]{ return !pendingConns.empty(); });
+                fd = pendingConns.front(); pendingConns.pop_front();
+            }
+            if (fd < 0) return;
+            serveConnection(fd, cache);
+        }
+    });
+    cout << "Serving on " << socketPath << " with " << threads << " threads, cache of " << cacheSize << " mazes" << endl;
+    for (;;) {
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) { if (errno == EINTR) continue; perror("accept"); break; }
+        { lock_guard<mutex> lk(mu); pendingConns.push_back(fd); }
+        ready.notify_one();
+    }
+    { lock_guard<mutex> lk(mu); for (size_t t = 0; t < workers.size(); ++t) pendingConns.push_back(-1); }
+    ready.notify_all();
+    for (auto &w : workers) w.join();
+    ::close(listener);
+    unlink(socketPath.c_str());
+    return 0;
+}
+#else
+static int runServer(const string &, int, size_t){
+    cerr << "--serve needs Unix domain sockets and is not available on Windows\n";
+    return 1;
+}
+#endif
+
+// ---- Benchmarking -----------------------------------------------------------
+// Every solver runs `warmup` untimed times, then `reps` timed times on a
+// steady_clock in nanoseconds. Reports use the median (robust against the odd
+// preempted run) together with p95 and the sample standard deviation.
+struct BenchOptions {
+    int warmup = 1, reps = 5;
+    string jsonPath, csvPath;
+    vector<string> sweep;       // mazes for a size-scaling sweep
+};
+
+struct RunResult {
+    string name;
+    vector<Cell> path;
+    vector<long long> ns;       // one entry per timed repetition
+    double medianNs{}, p95Ns{}, meanNs{}, stddevNs{};
+    long long expanded{};       // cells expanded by one run
+    size_t rssBytes{};          // resident set after the solver returned
+    size_t peakRssDelta{};      // largest peak resident growth over the repetitions
+    bool peakExact{};           // false when the peak could not be reset first
+    size_t allocBytes{}, allocCount{}, peakLiveBytes{};   // MAZE_COUNT_ALLOCS only
+    double ms() const { return medianNs / 1e6; }
+    double expandedPerSec() const { return medianNs > 0 ? expanded * 1e9 / medianNs : 0; }
+};
+
+static void summarize(RunResult &r){
+    vector<long long> v = r.ns;
+    sort(v.begin(), v.end());
+    const size_t n = v.size();
+    if (!n) return;
+    r.medianNs = n % 2 ? double(v[n / 2]) : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+    r.p95Ns = double(v[size_t(ceil(0.95 * n)) - 1]);   // nearest rank
+    double sum = 0, sq = 0;
+    for (long long x : v) sum += double(x);
+    r.meanNs = sum / n;
+    for (long long x : v) sq += (x - r.meanNs) * (x - r.meanNs);
+    r.stddevNs = n > 1 ? sqrt(sq / (n - 1)) : 0;
+}
+
+// Solvers run on their thread's search state (threadSearch), which the
+// warm-up reps grow to size
+typedef vector<Cell> (*SolverFn)(const MazeData&);
+
+template <class Solver>
+static RunResult runOne(const string &name, const MazeData &m, Solver solver, const BenchOptions &opt){
+    RunResult r; r.name = name;
+    for (int i = 0; i < opt.warmup; ++i) solver(m);
+    r.peakExact = true;
+    for (int i = 0; i < opt.reps; ++i) {
+        const bool exact = resetPeakMemory();
+        const MemorySample before = sampleMemory();
+#ifdef MAZE_COUNT_ALLOCS
+        const size_t bytes0 = allocBytesTotal, count0 = allocCountTotal, live0 = liveBytes;
+        peakLiveBytes = live0;
+#endif
+        cellsExpanded = 0;
+        auto t0 = chrono::steady_clock::now();
+        auto path = solver(m);
+        auto t1 = chrono::steady_clock::now();
+        r.ns.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        r.expanded = cellsExpanded;
+#ifdef MAZE_COUNT_ALLOCS
+        r.allocBytes = allocBytesTotal - bytes0;
+        r.allocCount = allocCountTotal - count0;
+        r.peakLiveBytes = peakLiveBytes - live0;
+#endif
+        const MemorySample after = sampleMemory();
+        const size_t base = exact ? before.rss : before.peakRss;
+        r.rssBytes = after.rss;
+        r.peakRssDelta = max(r.peakRssDelta, after.peakRss > base ? after.peakRss - base : 0);
+        r.peakExact = r.peakExact && exact;
+        r.path = std::move(path);
+    }
+    summarize(r);
+    return r;
+}
+
+// Memory lines shared by results.txt and the console report
+static void writeMemory(ostream &out, const RunResult &r){
+    out << "Memory(bytes, RSS after): " << r.rssBytes << "\n";
+    out << "Peak RSS growth(bytes): " << r.peakRssDelta << (r.peakExact ? "" : " (lower bound)") << "\n";
+#ifdef MAZE_COUNT_ALLOCS
+    out << "Heap allocated(bytes): " << r.allocBytes << " in " << r.allocCount << " allocations, peak live " << r.peakLiveBytes << "\n";
+#endif
+}
+
+static void writeTiming(ostream &out, const RunResult &r){
+    const auto flags = out.flags(); const auto prec = out.precision();
+    out << fixed << setprecision(3);
+    out << "Time(ms): " << r.ms() << " median, " << r.p95Ns / 1e6 << " p95, " << r.stddevNs / 1e6
+        << " stddev over " << r.ns.size() << " runs\n";
+    out << setprecision(0);
+    out << "Cells expanded: " << r.expanded << " (" << r.expandedPerSec() << " cells/s)\n";
+    out.flags(flags); out.precision(prec);
+}
+
+// Fastest solver among those whose path is optimal: a quick wrong answer
+// (DFS, a near-optimal HPA* route) is not a useful "fastest" solution.
+static const RunResult *pickFastest(const vector<RunResult> &all, const MazeData &m){
+    long long best = LLONG_MAX;
+    for (const auto &r : all) if (!r.path.empty()) best = min(best, pathCost(m, r.path));
+    const RunResult *fastest = nullptr;
+    for (const auto &r : all) {
+        if (r.path.empty() || pathCost(m, r.path) != best) continue;
+        if (!fastest || r.medianNs < fastest->medianNs) fastest = &r;
+    }
+    return fastest;
+}
+
+// ---- Path output ----------------------------------------------------------------
+// Paths are written as the start cell plus run-length moves: "3 1 R12D3L"
+// starts at (3,1), goes 12 right, 3 down, then 1 left (a count of 1 is left
+// out). The binary form (.mzp) is a PathFileHeader, the solver name, then one
+// LEB128 varint per run holding count << 2 | direction (DR/DC order).
+static const char PATH_MAGIC[4] = {'M','Z','P','1'};
+
+struct PathFileHeader {
+    char magic[4];
+    uint32_t nameLength;
+    int32_t sr, sc;
+    uint64_t steps, runs;
+};
+static_assert(sizeof(PathFileHeader) == 32, "PathFileHeader must stay 32 bytes");
+
+// Output through one large buffer; numbers are formatted with to_chars
+class BufferedWriter {
+public:
+    explicit BufferedWriter(const string &path, size_t capacity = size_t(1) << 20)
+        : f(fopen(path.c_str(), "wb")), buf(max<size_t>(capacity, 64)) {}
+    ~BufferedWriter(){ close(); }
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter &operator=(const BufferedWriter&) = delete;
+
+    bool isOpen() const { return f != nullptr; }
+    void put(char ch){ if (used == buf.size()) flush(); buf[used++] = ch; }
+    void put(string_view s){ write(s.data(), s.size()); }
+    void write(const void *data, size_t n){
+        if (n > buf.size() - used) flush();
+        if (n >= buf.size()) { if (f && fwrite(data, 1, n, f) != n) failed = true; return; }
+        memcpy(buf.data() + used, data, n); used += n;
+    }
+    template <class Int> void putInt(Int v){
+        if (buf.size() - used < 24) flush();
+        used = size_t(to_chars(buf.data() + used, buf.data() + buf.size(), v).ptr - buf.data());
+    }
+    void putVarint(uint64_t v){
+        if (buf.size() - used < 10) flush();
+        for (; v >= 0x80; v >>= 7) buf[used++] = char(v | 0x80);
+        buf[used++] = char(v);
+    }
+    // Flushes and closes; false if anything failed to write
+    bool close(){
+        if (!f) return false;
+        flush();
+        const bool good = !failed && fclose(f) == 0;
+        f = nullptr;
+        return good;
+    }
+private:
+    FILE *f;
+    vector<char> buf;
+    size_t used = 0;
+    bool failed = false;
+    void flush(){ if (f && used && fwrite(buf.data(), 1, used, f) != used) failed = true; used = 0; }
+};
+
+static inline int moveDir(Cell a, Cell b){ return b.row < a.row ? 0 : b.col > a.col ? 1 : b.row > a.row ? 2 : 3; }
+
+// emit(direction, count) for each run of equal moves along a contiguous path
+template <class Emit>
+static void forEachRun(const vector<Cell> &path, Emit emit){
+    for (size_t i = 1; i < path.size();) {
+        const int k = moveDir(path[i - 1], path[i]);
+        size_t j = i + 1;
+        while (j < path.size() && moveDir(path[j - 1], path[j]) == k) ++j;
+        emit(k, j - i);
+        i = j;
+    }
+}
+
+// "r c RUNS", or "none" for an empty path
+static void writePathRle(BufferedWriter &out, const vector<Cell> &path){
+    if (path.empty()) { out.put("none"); return; }
+    out.putInt(path[0].row); out.put(' '); out.putInt(path[0].col);
+    if (path.size() > 1) out.put(' ');
+    forEachRun(path, [&](int k, size_t n){ out.put(MOVE_CHARS[k]); if (n > 1) out.putInt(n); });
+}
+
+static bool writePathBinary(const string &file, const string &name, const vector<Cell> &path){
+    BufferedWriter out(file);
+    if (!out.isOpen()) return false;
+    PathFileHeader h{};
+    memcpy(h.magic, PATH_MAGIC, 4);
+    h.nameLength = uint32_t(name.size());
+    h.sr = path.empty() ? -1 : path[0].row; h.sc = path.empty() ? -1 : path[0].col;
+    h.steps = path.empty() ? 0 : path.size() - 1;
+    forEachRun(path, [&](int, size_t){ ++h.runs; });
+    out.write(&h, sizeof h);
+    out.put(name);
+    forEachRun(path, [&](int k, size_t n){ out.putVarint(uint64_t(n) << 2 | unsigned(k)); });
+    return out.close();
+}
+
+static bool saveResults(const vector<RunResult> &all, const RunResult *fastest, const string &outPath, const MazeData &m){
+    BufferedWriter out(outPath);
+    if (!out.isOpen()) return false;
+    ostringstream head;
+    head << "Maze: " << m.height << "x" << m.width << " Start:("<<m.sr<<","<<m.sc<<") End:("<<m.er<<","<<m.ec<<")\n";
+    head << "Paths: start row col, then moves U/R/D/L with repeat counts\n\n";
+    out.put(head.str());
+    for (const auto &r: all){
+        ostringstream block;
+        block << "Algorithm: " << r.name << "\n";
+        writeTiming(block, r);
+        writeMemory(block, r);
+        block << "Path length: " << r.path.size() << "\n";
+        if (m.grid.weighted()) block << "Path cost: " << pathCost(m, r.path) << "\n";
+        block << "Path: ";
+        out.put(block.str());
+        writePathRle(out, r.path);
+        out.put("\n\n");
+    }
+    if (!fastest) { out.put("FASTEST: none (no path)\n"); return out.close(); }
+    ostringstream tail;
+    tail << "FASTEST: " << fastest->name << " (" << fixed << setprecision(3) << fastest->ms() << " ms median)\n";
+    tail << "Fastest path length: " << fastest->path.size() << "\n";
+    tail << "Fastest path: ";
+    out.put(tail.str());
+    writePathRle(out, fastest->path);
+    out.put('\n');
+    return out.close();
+}
+
+// fastest.txt for report_gui.py: solver name, then "rle " + the encoded path
+static bool saveFastest(const RunResult *fastest, const string &outPath){
+    BufferedWriter out(outPath);
+    if (!out.isOpen()) return false;
+    if (fastest) {
+        out.put(fastest->name); out.put("\nrle ");
+        writePathRle(out, fastest->path);
+        out.put('\n');
+    }
+    return out.close();
+}
+
+// ---- Image rendering ------------------------------------------------------------
+// Writes the maze, a path overlay and optionally a heatmap of the cells a
+// search settled, as binary PPM or PNG. Images are produced one pixel row at a
+// time straight from GridStorage; the only per-render state is the sorted path
+// and one row of accumulators. Mazes larger than the requested size are box
+// downsampled (each pixel averages an f x f block of cells; a block touched by
+// the path shows as path), small ones are scaled up to whole pixels per cell.
+// The PNG is written with stored (uncompressed) deflate blocks, one IDAT chunk
+// per row, so it needs no zlib and streams like the PPM.
+struct RenderOptions {
+    string path;                               // single image, .ppm or .png
+    int maxSide = 4096;                        // longest image side in pixels
+    bool heatmap = false;
+    string tileDir;                            // tile pyramid root, empty = none
+    int tileSize = 256;
+};
+
+static const uint8_t COLOR_OPEN[3] = {0x20, 0x20, 0x20}, COLOR_WALL[3] = {0x44, 0x44, 0x44};
+static const uint8_t COLOR_PATH[3] = {0x00, 0xbc, 0xd4}, COLOR_START[3] = {0x2e, 0xcc, 0x71}, COLOR_END[3] = {0xe7, 0x4c, 0x3c};
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *p, size_t n){
+    static const auto table = []{
+        array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+class ImageWriter {
+public:
+    ImageWriter(const string &file, int width, int height)
+        : out(file), w(width), h(height), png(file.size() < 4 || file.compare(file.size() - 4, 4, ".ppm") != 0) {
+        if (!out.isOpen()) return;
+        if (!png) {
+            const string head = "P6\n" + to_string(w) + " " + to_string(h) + "\n255\n";
+            out.put(head);
+            return;
+        }
+        static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        out.write(SIGNATURE, 8);
+        uint8_t ihdr[13] = {};
+        putBE(ihdr, uint32_t(w)); putBE(ihdr + 4, uint32_t(h));
+        ihdr[8] = 8; ihdr[9] = 2;              // 8-bit RGB, no interlace
+        chunk("IHDR", ihdr, 13);
+    }
+    bool isOpen() const { return out.isOpen(); }
+
+    // One row of w RGB pixels
+    void row(const uint8_t *rgb){
+        const size_t n = size_t(w) * 3;
+        if (!png) { out.write(rgb, n); return; }
+        // zlib stream: header once, then the row (filter byte 0 + pixels) as
+        // stored blocks of at most 65535 bytes
+        const size_t raw = n + 1, blocks = (raw + 65534) / 65535;
+        const uint32_t len = uint32_t((rowsDone == 0 ? 2 : 0) + raw + 5 * blocks);
+        beginChunk("IDAT", len);
+        if (rowsDone == 0) { static const uint8_t ZHEAD[2] = {0x78, 0x01}; data(ZHEAD, 2); }
+        size_t done = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t take = min<size_t>(65535, raw - done);
+            const uint8_t head[5] = {0, uint8_t(take), uint8_t(take >> 8), uint8_t(~take), uint8_t(~take >> 8)};
+            data(head, 5);
+            size_t i = 0;
+            if (done == 0) { const uint8_t filter = 0; data(&filter, 1); adler(&filter, 1); i = 1; }
+            const uint8_t *px = rgb + (done + i - 1);
+            data(px, take - i); adler(px, take - i);
+            done += take;
+        }
+        endChunk();
+        ++rowsDone;
+    }
+
+    bool finish(){
+        if (png) {
+            uint8_t tail[9] = {1, 0, 0, 0xff, 0xff};   // empty final stored block
+            putBE(tail + 5, adlerB << 16 | adlerA);
+            chunk("IDAT", tail, 9);
+            chunk("IEND", nullptr, 0);
+        }
+        return out.close();
+    }
+
+private:
+    BufferedWriter out;
+    int w, h, rowsDone = 0;
+    bool png;
+    uint32_t crc = 0, adlerA = 1, adlerB = 0;
+
+    static void putBE(uint8_t *p, uint32_t v){ p[0] = uint8_t(v >> 24); p[1] = uint8_t(v >> 16); p[2] = uint8_t(v >> 8); p[3] = uint8_t(v); }
+    void beginChunk(const char *type, uint32_t len){
+        uint8_t head[4]; putBE(head, len);
+        out.write(head, 4);
+        out.write(type, 4);
+        crc = crc32Update(0, reinterpret_cast<const uint8_t*>(type), 4);
+    }
+    void data(const uint8_t *p, size_t n){ if (n) { out.write(p, n); crc = crc32Update(crc, p, n); } }
+    void endChunk(){ uint8_t tail[4]; putBE(tail, crc); out.write(tail, 4); }
+    void chunk(const char *type, const uint8_t *p, uint32_t n){ beginChunk(type, n); data(p, n); endChunk(); }
+    void adler(const uint8_t *p, size_t n){
+        for (size_t i = 0; i < n; ++i) {
+            adlerA += p[i];
+            if (adlerA >= 65521) adlerA -= 65521;
+            adlerB += adlerA;
+            if (adlerB >= 65521) adlerB -= 65521;
+        }
+    }
+};
+
+// Produces image rows at a given downsampling factor. `heat`, when set, gives
+// the distance a search reached each cell at (-1 = not reached); reached
+// cells are coloured by distance from dark blue (near) to orange (far).
+typedef function<long long(size_t)> HeatFn;
+
+class MazeRenderer {
+public:
+    MazeRenderer(const MazeData &m, const vector<Cell> &path, HeatFn heat, long long heatMax)
+        : m(m), heat(std::move(heat)), heatMax(max(1LL, heatMax)) {
+        ids.reserve(path.size());
+        for (const auto &p : path) ids.push_back(uint64_t(p.row) * m.width + p.col);
+        sort(ids.begin(), ids.end());
+    }
+
+    // Row y of the image where each pixel covers f x f cells (w = ceil(W/f))
+    void row(int f, int y, vector<uint8_t> &rgb){
+        const int w = (m.width + f - 1) / f;
+        const int r0 = y * f, r1 = min(m.height, r0 + f);
+        acc.assign(size_t(w) * 3, 0);
+        rgb.resize(size_t(w) * 3);
+        for (int r = r0; r < r1; ++r)
+            for (int c = 0; c < m.width; ++c) {
+                uint8_t col[3];
+                cellColor(r, c, col);
+                uint32_t *a = &acc[size_t(c / f) * 3];
+                a[0] += col[0]; a[1] += col[1]; a[2] += col[2];
+            }
+        for (int x = 0; x < w; ++x) {
+            const uint32_t n = uint32_t(r1 - r0) * uint32_t(min(m.width, (x + 1) * f) - x * f);
+            for (int k = 0; k < 3; ++k) rgb[size_t(x) * 3 + k] = uint8_t(acc[size_t(x) * 3 + k] / n);
+        }
+        auto paint = [&](int c, const uint8_t *col){ memcpy(&rgb[size_t(c / f) * 3], col, 3); };
+        for (auto it = lower_bound(ids.begin(), ids.end(), uint64_t(r0) * m.width);
+             it != ids.end() && *it < uint64_t(r1) * m.width; ++it) paint(int(*it % m.width), COLOR_PATH);
+        if (m.sr >= r0 && m.sr < r1) paint(m.sc, COLOR_START);
+        if (m.er >= r0 && m.er < r1) paint(m.ec, COLOR_END);
+    }
+
+private:
+    const MazeData &m;
+    HeatFn heat;
+    long long heatMax;
+    vector<uint64_t> ids;                      // path cells, row-major
+    vector<uint32_t> acc;
+
+    void cellColor(int r, int c, uint8_t *col) const {
+        if (!m.grid.open(r, c)) { memcpy(col, COLOR_WALL, 3); return; }
+        const size_t i = size_t(r) * m.width + c;
+        if (const long long d = heat ? heat(i) : -1; d >= 0) {
+            const double t = min(1.0, double(d) / heatMax);
+            col[0] = uint8_t(30 + 220 * t); col[1] = uint8_t(30 + 130 * t); col[2] = uint8_t(120 - 90 * t);
+            return;
+        }
+        const int cost = m.grid.cost(r, c);
+        if (cost > 1) {                        // terrain, brighter = costlier (as report_gui.py)
+            const int shade = 0x20 + cost * 12;
+            col[0] = uint8_t(shade); col[1] = uint8_t(shade / 2 + 0x10); col[2] = 0x20;
+            return;
+        }
+        memcpy(col, COLOR_OPEN, 3);
+    }
+};
+
+// Whole maze in one image no larger than maxSide: downsampled when the maze is
+// bigger, otherwise every cell drawn as a px x px square (px <= 8)
+static bool renderImage(MazeRenderer &rr, const MazeData &m, const string &file, int maxSide){
+    const int side = max(m.height, m.width);
+    const int f = max(1, (side + maxSide - 1) / maxSide);
+    const int px = f > 1 ? 1 : max(1, min(8, maxSide / side));
+    const int w = (m.width + f - 1) / f, h = (m.height + f - 1) / f;
+    ImageWriter img(file, w * px, h * px);
+    if (!img.isOpen()) return false;
+    vector<uint8_t> cells, line(size_t(w) * px * 3);
+    for (int y = 0; y < h; ++y) {
+        rr.row(f, y, cells);
+        for (int x = 0; x < w * px; ++x) memcpy(&line[size_t(x) * 3], &cells[size_t(x / px) * 3], 3);
+        for (int k = 0; k < px; ++k) img.row(line.data());
+    }
+    cout << "Rendered " << file << " (" << w * px << "x" << h * px << ", "
+         << (f > 1 ? to_string(f) + " cells per pixel side" : to_string(px) + " px per cell") << ")\n";
+    return img.finish();
+}
+
+// Tile pyramid DIR/<level>/<row>_<col>.png: level 0 is one pixel per cell and
+// each level halves the resolution, up to the first level that fits one tile.
+// A band of tiles is written at a time, so only one pixel row is held.
+static bool renderTiles(MazeRenderer &rr, const MazeData &m, const string &dir, int T){
+    int level = 0;
+    for (int f = 1;; f *= 2, ++level) {
+        const int w = (m.width + f - 1) / f, h = (m.height + f - 1) / f;
+        const string levelDir = dir + "/" + to_string(level);
+#ifdef _WIN32
+        CreateDirectoryA(dir.c_str(), nullptr); CreateDirectoryA(levelDir.c_str(), nullptr);
+#else
+        mkdir(dir.c_str(), 0755); mkdir(levelDir.c_str(), 0755);
+#endif
+        const int across = (w + T - 1) / T, down = (h + T - 1) / T;
+        vector<uint8_t> line;
+        for (int ty = 0; ty < down; ++ty) {
+            const int th = min(T, h - ty * T);
+            vector<unique_ptr<ImageWriter>> tiles;
+            for (int tx = 0; tx < across; ++tx) {
+                tiles.emplace_back(new ImageWriter(levelDir + "/" + to_string(ty) + "_" + to_string(tx) + ".png", min(T, w - tx * T), th));
+                if (!tiles.back()->isOpen()) return false;
+            }
+            for (int y = ty * T; y < ty * T + th; ++y) {
+                rr.row(f, y, line);
+                for (int tx = 0; tx < across; ++tx) tiles[tx]->row(&line[size_t(tx) * T * 3]);
+            }
+            for (auto &t : tiles) if (!t->finish()) return false;
+        }
+        if (across == 1 && down == 1) break;
+    }
+    cout << "Rendered tile pyramid " << dir << " (" << level + 1 << " levels of " << T << "px tiles)\n";
+    return true;
+}
+
+static bool renderOutputs(const MazeData &m, const vector<Cell> &path, const RenderOptions &opt){
+    HeatFn heat;
+    long long heatMax = 1;
+    if (opt.heatmap) {
+        // the thread's search keeps Dijkstra's distances until its next solve
+        solveDijkstra(m);
+        auto lookup = [](const auto &search) -> HeatFn {
+            return [&search](size_t i){ return search.reached(i) ? (long long)search.distance(i) : -1LL; };
+        };
+        heat = m.grid.weighted() ? lookup(threadSearch<CoreSearch<maze_core::ByteCost, maze_core::BinaryHeap>>())
+                                 : lookup(threadSearch<CoreSearch<maze_core::UnitCost, maze_core::BinaryHeap>>());
+        const size_t cells = size_t(m.height) * m.width;
+        for (size_t i = 0; i < cells; ++i) heatMax = max(heatMax, heat(i));
+    }
+    MazeRenderer rr(m, path, heat, heatMax);
+    bool ok = true;
+    if (!opt.path.empty() && !renderImage(rr, m, opt.path, max(1, opt.maxSide))) {
+        cerr << "Failed to write " << opt.path << '\n'; ok = false;
+    }
+    if (!opt.tileDir.empty() && !renderTiles(rr, m, opt.tileDir, max(16, opt.tileSize))) {
+        cerr << "Failed to write tiles under " << opt.tileDir << '\n'; ok = false;
+    }
+    return ok;
+}
+
+// One flat record per (maze, solver) for the JSON / CSV exports
+struct BenchRow {
+    string maze, algorithm;
+    int height, width;
+    size_t openCells;
+    size_t reps;
+    double medianNs, p95Ns, meanNs, stddevNs;
+    long long minNs, expanded;
+    double expandedPerSec;
+    size_t pathLength;
+    long long pathCost;
+    size_t peakRssDelta, allocBytes;
+};
+
+static size_t countOpenCells(const MazeData &m){
+    size_t n = 0;
+    for (size_t i = 0; i < m.grid.wordCount(); ++i) n += bitset<64>(m.grid.bits[i]).count();
+    return n;
+}
+
+static BenchRow benchRow(const string &maze, const MazeData &m, size_t openCells, const RunResult &r){
+    return BenchRow{maze, r.name, m.height, m.width, openCells, r.ns.size(),
+                    r.medianNs, r.p95Ns, r.meanNs, r.stddevNs,
+                    r.ns.empty() ? 0 : *min_element(r.ns.begin(), r.ns.end()), r.expanded, r.expandedPerSec(),
+                    r.path.size(), r.path.empty() ? -1 : pathCost(m, r.path), r.peakRssDelta, r.allocBytes};
+}
+
+static string jsonString(const string &s){
+    string out = "\"";
+    for (char ch : s) { if (ch == '"' || ch == '\\') out += '\\'; out += ch; }
+    return out + "\"";
+}
+
+static bool writeBenchCsv(const string &path, const vector<BenchRow> &rows){
+    ofstream out(path);
+    if (!out) return false;
+    out << "maze,algorithm,height,width,open_cells,reps,median_ns,p95_ns,mean_ns,stddev_ns,min_ns,"
+           "cells_expanded,cells_per_sec,path_length,path_cost,peak_rss_delta,alloc_bytes\n";
+    out << fixed << setprecision(0);
+    for (const auto &b : rows)
+        out << b.maze << ",\"" << b.algorithm << "\"," << b.height << ',' << b.width << ',' << b.openCells << ','
+            << b.reps << ',' << b.medianNs << ',' << b.p95Ns << ',' << b.meanNs << ',' << b.stddevNs << ','
+            << b.minNs << ',' << b.expanded << ',' << b.expandedPerSec << ',' << b.pathLength << ','
+            << b.pathCost << ',' << b.peakRssDelta << ',' << b.allocBytes << '\n';
+    return bool(out);
+}
+
+static bool writeBenchJson(const string &path, const vector<BenchRow> &rows, const BenchOptions &opt){
+    ofstream out(path);
+    if (!out) return false;
+    out << fixed << setprecision(0);
+    out << "{\n  \"warmup\": " << opt.warmup << ",\n  \"reps\": " << opt.reps << ",\n  \"results\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const BenchRow &b = rows[i];
+        out << (i ? ",\n" : "\n") << "    {\"maze\": " << jsonString(b.maze) << ", \"algorithm\": " << jsonString(b.algorithm)
+            << ", \"height\": " << b.height << ", \"width\": " << b.width << ", \"open_cells\": " << b.openCells
+            << ", \"reps\": " << b.reps << ", \"median_ns\": " << b.medianNs << ", \"p95_ns\": " << b.p95Ns
+            << ", \"mean_ns\": " << b.meanNs << ", \"stddev_ns\": " << b.stddevNs << ", \"min_ns\": " << b.minNs
+            << ", \"cells_expanded\": " << b.expanded << ", \"cells_per_sec\": " << b.expandedPerSec
+            << ", \"path_length\": " << b.pathLength << ", \"path_cost\": " << b.pathCost
+            << ", \"peak_rss_delta\": " << b.peakRssDelta << ", \"alloc_bytes\": " << b.allocBytes << "}";
+    }
+    out << "\n  ]\n}\n";
+    return bool(out);
+}
+
+// The HPA* index lives next to the maze and is only rebuilt when missing or stale
+static void prepareHpa(HpaIndex &hpa, const string &mazePath, const MazeData &m, int K){
+    if (!hpa.load(mazePath + ".hpa", m) || hpa.K != K) {
+        auto t0 = chrono::steady_clock::now();
+        hpa.build(m, K);
+        auto t1 = chrono::steady_clock::now();
+        if (!hpa.save(mazePath + ".hpa")) cerr << "Warning: could not write " << mazePath << ".hpa\n";
+        cout << "HPA* index built in " << chrono::duration_cast<chrono::milliseconds>(t1-t0).count() << " ms";
+    } else {
+        cout << "HPA* index loaded from " << mazePath << ".hpa";
+    }
+    cout << " (" << hpa.nodeCount() << " abstract nodes)\n";
+}
+
+// Junction graph for the maze, from mazePath + ".jg" / ".jgf" when cached
+static void prepareJunctions(JunctionGraph &jg, const string &mazePath, const MazeData &m, bool fillDeadEnds){
+    const string cache = mazePath + (fillDeadEnds ? ".jgf" : ".jg");
+    if (!jg.load(cache, m, fillDeadEnds)) {
+        auto t0 = chrono::steady_clock::now();
+        jg.build(m, fillDeadEnds);
+        auto t1 = chrono::steady_clock::now();
+        if (!jg.save(cache)) cerr << "Warning: could not write " << cache << "\n";
+        cout << "Junction graph" << (fillDeadEnds ? " (dead ends filled)" : "") << " built in "
+             << chrono::duration_cast<chrono::milliseconds>(t1-t0).count() << " ms";
+    } else {
+        cout << "Junction graph" << (fillDeadEnds ? " (dead ends filled)" : "") << " loaded from " << cache;
+    }
+    cout << " (" << jg.nodeCount() << " nodes, " << jg.edgeCount() << " edges)\n";
+}
+
+static const char *BFS_NAME = "BFS (BFS.cpp)";
+static const char *PARALLEL_PREFIX = "Parallel BFS";
+
+// ---- Portfolio race -------------------------------------------------------------
+// Runs several solvers at once on one shared, read-only MazeData, one thread
+// each, and takes the first answer that meets the required quality. With
+// --race shortest only solvers that prove optimality on this maze are
+// entered, and a proven "no path" from one of them counts as an answer too.
+// With --race any every path counts. The winner cancels the rest through a
+// CancelToken. Threads stay alive across repetitions, so their search state
+// stays warm. The first-answer latency is compared with running the same solvers
+// one after another, as the normal benchmark does.
+struct PortfolioEntry {
+    const char *key, *name;
+    SolverFn solve;
+    bool exactPlain, exactWeighted;            // proves a shortest path on plain / terrain mazes
+};
+
+static const PortfolioEntry PORTFOLIO[] = {
+    {"bfs", BFS_NAME, SolverFn(solveBFS), true, false},
+    {"dijkstra", "Dijkstra (custom.cpp)", SolverFn(solveDijkstra), true, true},
+    {"dial", "Dijkstra (Dial buckets)", SolverFn(solveDial), true, true},
+    {"astar", "A* (Manhattan)", SolverFn(solveAStar), true, true},
+    {"jps", "Jump Point Search", SolverFn(solveJPS), true, true},
+    {"bidir-bfs", "Bidirectional BFS", SolverFn(solveBidirBFS), true, false},
+    {"bidir-dijkstra", "Bidirectional Dijkstra", SolverFn(solveBidirDijkstra), true, true},
+    {"dfs", "DFS (stl.cpp)", SolverFn(solveDFS), false, false},
+    {"wall", "Wall follower (MazeSequentialIterator.cpp)", solveWallFollower, false, false},
+};
+
+static int runRace(const MazeData &m, const string &quality, const vector<string> &keys, const BenchOptions &opt){
+    const bool needShortest = quality == "shortest";
+    if (!needShortest && quality != "any") { cerr << "--race takes any or shortest\n"; return 1; }
+    vector<const PortfolioEntry*> entrants;
+    for (const auto &e : PORTFOLIO) {
+        if (!keys.empty() && find(keys.begin(), keys.end(), e.key) == keys.end()) continue;
+        if (needShortest && !(m.grid.weighted() ? e.exactWeighted : e.exactPlain)) continue;
+        entrants.push_back(&e);
+    }
+    if (entrants.empty()) { cerr << "No solver in the portfolio can give a " << quality << " answer here\n"; return 1; }
+
+    ThreadPool racers(int(entrants.size()));
+    const int reps = opt.warmup + opt.reps;
+    vector<long long> firstNs, totalNs, sequentialNs;
+    vector<int> wins(entrants.size(), 0);
+    vector<Cell> answer;
+    int lastWinner = -1;
+    for (int rep = 0; rep < reps; ++rep) {
+        CancelToken token;
+        atomic<int> winner{-1};
+        atomic<long long> wonAt{0};
+        vector<vector<Cell>> paths(entrants.size());
+        const auto t0 = chrono::steady_clock::now();
+        racers.run([&](int tid){
+            currentCancel = &token;
+            vector<Cell> path = entrants[tid]->solve(m);
+            currentCancel = nullptr;
+            // an empty result is an answer only from an exact solver that was not cancelled
+            const bool answered = !path.empty() || (needShortest && !token.cancelled());
+            int none = -1;
+            if (answered && winner.compare_exchange_strong(none, tid)) {
+                wonAt = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+                token.cancel();
+                paths[tid] = std::move(path);
+            }
+        });
+        const auto t1 = chrono::steady_clock::now();
+
+        // The same solvers back to back
+        const auto s0 = chrono::steady_clock::now();
+        for (const auto *e : entrants) e->solve(m);
+        const auto s1 = chrono::steady_clock::now();
+
+        if (rep < opt.warmup) continue;
+        lastWinner = winner;
+        if (lastWinner < 0) { firstNs.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count()); continue; }
+        ++wins[lastWinner];
+        answer = std::move(paths[lastWinner]);
+        firstNs.push_back(wonAt);
+        totalNs.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        sequentialNs.push_back(chrono::duration_cast<chrono::nanoseconds>(s1 - s0).count());
+    }
+
+    auto median = [](vector<long long> v){
+        if (v.empty()) return 0.0;
+        sort(v.begin(), v.end());
+        return v.size() % 2 ? double(v[v.size() / 2]) : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2.0;
+    };
+    cout << "Race (" << quality << "): " << entrants.size() << " solvers on " << entrants.size() << " threads, "
+         << opt.reps << " races\n";
+    for (size_t i = 0; i < entrants.size(); ++i)
+        cout << "  " << left << setw(44) << entrants[i]->name << right << wins[i] << " wins\n";
+    if (lastWinner < 0) { cout << "No solver produced an answer\n"; return 1; }
+    cout << "Winner of the last race: " << entrants[lastWinner]->name;
+    if (answer.empty()) cout << ", proved there is no path";
+    else cout << ", path length " << answer.size();
+    if (m.grid.weighted() && !answer.empty()) cout << ", cost " << pathCost(m, answer);
+    cout << "\n" << fixed << setprecision(3)
+         << "First answer:        " << median(firstNs) / 1e6 << " ms median\n"
+         << "Race incl. cancel:   " << median(totalNs) / 1e6 << " ms median\n"
+         << "Sequential (all):    " << median(sequentialNs) / 1e6 << " ms median\n"
+         << "Speedup: " << setprecision(2) << median(sequentialNs) / max(1.0, median(firstNs)) << "x\n";
+    return 0;
+}
+
+static vector<RunResult> runAll(const MazeData &m, const string &mazePath, ThreadPool &pool,
+                                const OutOfCoreOptions &ooc, int hpaCluster, const BenchOptions &opt){
+    HpaIndex hpa;
+    prepareHpa(hpa, mazePath, m, hpaCluster);
+    JunctionGraph junctions, filledJunctions;
+    prepareJunctions(junctions, mazePath, m, false);
+    prepareJunctions(filledJunctions, mazePath, m, true);
+    vector<RunResult> results;
+    results.push_back(runOne("Dijkstra (custom.cpp)", m, SolverFn(solveDijkstra), opt));
+    results.push_back(runOne("Dijkstra (Dial buckets)", m, SolverFn(solveDial), opt));
+    results.push_back(runOne("A* (Manhattan)", m, SolverFn(solveAStar), opt));
+    results.push_back(runOne("Jump Point Search", m, SolverFn(solveJPS), opt));
+    results.push_back(runOne(BFS_NAME, m, SolverFn(solveBFS), opt));
+    results.push_back(runOne("Bit-parallel BFS", m, solveBitBFS, opt));
+    results.push_back(runOne("Bidirectional BFS", m, SolverFn(solveBidirBFS), opt));
+    results.push_back(runOne("Bidirectional Dijkstra", m, SolverFn(solveBidirDijkstra), opt));
+    results.push_back(runOne(string(PARALLEL_PREFIX) + " (" + to_string(pool.size()) + " threads)", m,
+                             [&](const MazeData &md){ return solveParallelBFS(md, pool); }, opt));
+    results.push_back(runOne("Out-of-core BFS (" + to_string(ooc.budgetBytes >> 20) + " MB)", m,
+                             [&](const MazeData &md){ return solveOutOfCoreBFS(md, ooc); }, opt));
+    results.push_back(runOne("HPA* (cluster " + to_string(hpa.K) + ")", m,
+                             [&](const MazeData &md){ return hpa.query(md, md.sr, md.sc, md.er, md.ec); }, opt));
+    results.push_back(runOne("Junction graph Dijkstra", m,
+                             [&](const MazeData &md){ return junctions.solve(md); }, opt));
+    results.push_back(runOne("Junction graph (dead ends filled)", m,
+                             [&](const MazeData &md){ return filledJunctions.solve(md); }, opt));
+    results.push_back(runOne("DFS (stl.cpp)", m, SolverFn(solveDFS), opt));
+    results.push_back(runOne("Wall follower (MazeSequentialIterator.cpp)", m, solveWallFollower, opt));
+    results.push_back(runOne("Raster Sweep (mazesequential.cpp)", m, SolverFn(solveSweep), opt));
+    return results;
+}
+
+// Size-scaling sweep: every solver on every maze, then one line per solver
+// with its median time per size and the local growth exponent
+// log(t2/t1) / log(n2/n1) between neighbouring sizes (1 = linear in cells).
+static int runSweep(ThreadPool &pool, const OutOfCoreOptions &ooc, int hpaCluster, const BenchOptions &opt){
+    vector<BenchRow> rows;
+    for (const string &path : opt.sweep) {
+        MazeData m;
+        if (!loadMaze(path, m)) { cerr << "Failed to read " << path << '\n'; return 1; }
+        cout << "\n== " << path << " (" << m.height << "x" << m.width << ")\n";
+        const size_t open = countOpenCells(m);
+        for (const auto &r : runAll(m, path, pool, ooc, hpaCluster, opt)) {
+            rows.push_back(benchRow(path, m, open, r));
+            cout << "  " << left << setw(36) << r.name << right << fixed << setprecision(3)
+                 << setw(12) << r.ms() << " ms  p95 " << setw(10) << r.p95Ns / 1e6
+                 << "  " << setprecision(0) << setw(12) << r.expandedPerSec() << " cells/s\n";
+        }
+    }
+    cout << "\nScaling (median ms @ open cells, growth exponent in brackets):\n";
+    map<string, vector<const BenchRow*>> byAlgo;
+    for (const auto &b : rows) byAlgo[b.algorithm].push_back(&b);
+    for (auto &kv : byAlgo) {
+        auto &v = kv.second;
+        sort(v.begin(), v.end(), [](const BenchRow *a, const BenchRow *b){ return a->openCells < b->openCells; });
+        cout << "  " << kv.first << ":";
+        for (size_t i = 0; i < v.size(); ++i) {
+            cout << "  " << fixed << setprecision(3) << v[i]->medianNs / 1e6 << "@" << v[i]->openCells;
+            if (i && v[i]->openCells > v[i-1]->openCells && v[i-1]->medianNs > 0 && v[i]->medianNs > 0)
+                cout << " [" << setprecision(2) << log(v[i]->medianNs / v[i-1]->medianNs) / log(double(v[i]->openCells) / v[i-1]->openCells) << "]";
+        }
+        cout << '\n';
+    }
+    if (!opt.csvPath.empty() && !writeBenchCsv(opt.csvPath, rows)) cerr << "Failed to write " << opt.csvPath << '\n';
+    if (!opt.jsonPath.empty() && !writeBenchJson(opt.jsonPath, rows, opt)) cerr << "Failed to write " << opt.jsonPath << '\n';
+    return 0;
+}
+
+int main(int argc, char **argv){
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    int threads = max(1u, thread::hardware_concurrency());
+    string mazePath = "maze.txt", convertTo;
+    OutOfCoreOptions ooc;
+    int hpaCluster = 16;
+    string batchPath, batchOut = "batch_results.txt";
+    int replanEdits = 0, replanBatch = 1;
+    string raceQuality;
+    vector<string> raceSolvers;
+    string socketPath, pathBinary, tracePath;
+    RenderOptions render;
+    size_t cacheSize = 8;
+    BenchOptions bench;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+        else if (a == "--convert" && i + 1 < argc) convertTo = argv[++i];
+        else if (a == "--ooc-budget-mb" && i + 1 < argc) ooc.budgetBytes = size_t(max(1, atoi(argv[++i]))) << 20;
+        else if (a == "--scratch-dir" && i + 1 < argc) ooc.scratchDir = argv[++i];
+        else if (a == "--hpa-cluster" && i + 1 < argc) hpaCluster = max(2, atoi(argv[++i]));
+        else if (a == "--batch" && i + 1 < argc) batchPath = argv[++i];
+        else if (a == "--batch-out" && i + 1 < argc) batchOut = argv[++i];
+        else if (a == "--replan" && i + 1 < argc) replanEdits = max(1, atoi(argv[++i]));
+        else if (a == "--replan-batch" && i + 1 < argc) replanBatch = max(1, atoi(argv[++i]));
+        else if (a == "--race" && i + 1 < argc) raceQuality = argv[++i];
+        else if (a == "--race-solvers" && i + 1 < argc) {
+            stringstream list(argv[++i]);
+            for (string item; getline(list, item, ','); ) if (!item.empty()) raceSolvers.push_back(item);
+        }
+        else if (a == "--serve" && i + 1 < argc) socketPath = argv[++i];
+        else if (a == "--cache" && i + 1 < argc) cacheSize = size_t(max(1, atoi(argv[++i])));
+        else if (a == "--warmup" && i + 1 < argc) bench.warmup = max(0, atoi(argv[++i]));
+        else if (a == "--reps" && i + 1 < argc) bench.reps = max(1, atoi(argv[++i]));
+        else if (a == "--json" && i + 1 < argc) bench.jsonPath = argv[++i];
+        else if (a == "--csv" && i + 1 < argc) bench.csvPath = argv[++i];
+        else if (a == "--path-bin" && i + 1 < argc) pathBinary = argv[++i];
+        else if (a == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (a == "--render" && i + 1 < argc) render.path = argv[++i];
+        else if (a == "--render-max" && i + 1 < argc) render.maxSide = max(1, atoi(argv[++i]));
+        else if (a == "--heatmap") render.heatmap = true;
+        else if (a == "--tiles" && i + 1 < argc) render.tileDir = argv[++i];
+        else if (a == "--tile-size" && i + 1 < argc) render.tileSize = max(16, atoi(argv[++i]));
+        else if (a == "--sweep" && i + 1 < argc) {
+            stringstream list(argv[++i]);
+            for (string item; getline(list, item, ','); ) if (!item.empty()) bench.sweep.push_back(item);
+        }
+        else if (a[0] != '-') mazePath = a;
+        else {
+            cerr << "Usage: " << argv[0] << " [maze.txt|maze.mzb] [--threads N] [--convert out.mzb]"
+                 << " [--ooc-budget-mb N] [--scratch-dir DIR] [--hpa-cluster K]"
+                 << " [--batch queries.txt [--batch-out out.txt]]"
+                 << " [--replan EDITS [--replan-batch N]]"
+                 << " [--race any|shortest [--race-solvers bfs,astar,...]]"
+                 << " [--serve SOCKET [--cache N]]"
+                 << " [--warmup N] [--reps N] [--json out.json] [--csv out.csv] [--sweep a.txt,b.txt,...]"
+                 << " [--path-bin fastest.mzp] [--trace search.mzt]"
+                 << " [--render out.png|out.ppm [--render-max N]] [--tiles DIR [--tile-size N]] [--heatmap]" << '\n';
+            return 1;
+        }
+    }
+    if (!socketPath.empty()) return runServer(socketPath, threads, cacheSize);
+    ThreadPool pool(threads);
+    if (!bench.sweep.empty()) return runSweep(pool, ooc, hpaCluster, bench);
+
+    MazeData m; if(!loadMaze(mazePath, m)){ cerr << "Failed to read " << mazePath << '\n'; return 1; }
+    if (!convertTo.empty()) {
+        if (!writeMazeBinary(m, convertTo)) { cerr << "Failed to write " << convertTo << '\n'; return 1; }
+        cout << "Wrote " << convertTo << " (" << m.height << "x" << m.width << ")\n";
+        return 0;
+    }
+    cout << "Maze: " << m.height << "x" << m.width << " Start:("<<m.sr<<","<<m.sc<<") End:("<<m.er<<","<<m.ec<<")\n";
+    if (!batchPath.empty()) return runBatch(m, batchPath, batchOut) ? 0 : 1;
+    if (replanEdits) return runReplan(m, replanEdits, replanBatch) ? 0 : 1;
+    if (!raceQuality.empty()) return runRace(m, raceQuality, raceSolvers, bench);
+
+    vector<RunResult> results = runAll(m, mazePath, pool, ooc, hpaCluster, bench);
+    for (const auto &r: results){
+        cout << "\n["<< r.name << "]\n";
+        writeTiming(cout, r);
+        writeMemory(cout, r);
+        cout << "Path length: " << r.path.size() << "\n";
+        if (m.grid.weighted()) cout << "Path cost: " << pathCost(m, r.path) << "\n";
+        if (printable(m)) printMazeWithPath(m, r.path);
+    }
+    if (!printable(m))
+        cout << "\n(Maze larger than " << PRINT_MAX_SIDE << " per side: not printed, use --render FILE)\n";
+
+    const RunResult *bfs = nullptr, *par = nullptr;
+    for (const auto &r : results) {
+        if (r.name == BFS_NAME) bfs = &r;
+        if (r.name.rfind(PARALLEL_PREFIX, 0) == 0) par = &r;
+    }
+    cout << "\nParallel BFS speedup over BFS: " << fixed << setprecision(2) << bfs->medianNs / max(1.0, par->medianNs) << "x\n";
+
+    const RunResult *fastest = pickFastest(results, m);
+    if (fastest) cout << "\nFASTEST: " << fastest->name << " (" << setprecision(3) << fastest->ms() << " ms median)\n";
+
+    if (!saveResults(results, fastest, "results.txt", m)) cerr << "Failed to write results.txt\n";
+    if (!saveFastest(fastest, "fastest.txt")) cerr << "Failed to write fastest.txt\n";
+    if (!pathBinary.empty() && fastest && !writePathBinary(pathBinary, fastest->name, fastest->path))
+        cerr << "Failed to write " << pathBinary << '\n';
+    if (!render.path.empty() || !render.tileDir.empty())
+        renderOutputs(m, fastest ? fastest->path : vector<Cell>(), render);
+    if (!tracePath.empty()) traceDijkstra(m, tracePath);
+    if (!bench.csvPath.empty() || !bench.jsonPath.empty()) {
+        vector<BenchRow> rows;
+        const size_t open = countOpenCells(m);
+        for (const auto &r : results) rows.push_back(benchRow(mazePath, m, open, r));
+        if (!bench.csvPath.empty() && !writeBenchCsv(bench.csvPath, rows)) cerr << "Failed to write " << bench.csvPath << '\n';
+        if (!bench.jsonPath.empty() && !writeBenchJson(bench.jsonPath, rows, bench)) cerr << "Failed to write " << bench.jsonPath << '\n';
+    }
+    return 0;
+}
@@ -36,6 +36,18 @@ def generate_maze(width, height):
 
     return maze
 
+def generate_terrain(maze, ratio=0.3, max_cost=9):
+    """Assign random entry costs 2..max_cost to a fraction of the open cells.
+    Returns a grid of costs (1 = plain cell, walls are ignored)."""
+    height = len(maze)
+    width = len(maze[0]) if height > 0 else 0
+    weights = [[1 for _ in range(width)] for _ in range(height)]
+    for r in range(height):
+        for c in range(width):
+            if maze[r][c] == 0 and random.random() < ratio:
+                weights[r][c] = random.randint(2, max_cost)
+    return weights
+
 def print_maze(maze):
     for row in maze:
         print("".join(["#" if cell == 1 else " " for cell in row]))
@@ -67,14 +79,15 @@ def find_start_end_points(maze):
     
     return (start_row, start_col), (end_row, end_col)
 
-def save_maze_to_file(maze, filename="maze.txt"):
+def save_maze_to_file(maze, filename="maze.txt", weights=None):
     """
     Save maze to a text file in a format suitable for C++ parsing.
     Format:
     - First line: height width
     - Second line: start_row start_col
     - Third line: end_row end_col
-    - Each subsequent line: row of the maze (1 = wall, 0 = path, S = start, E = end)
+    - Each subsequent line: row of the maze (1 = wall, 0 = path, S = start, E = end,
+      2-9 = path cell with that entry cost, only when weights are given)
     """
     height = len(maze)
     width = len(maze[0]) if height > 0 else 0
@@ -100,6 +113,8 @@ def save_maze_to_file(maze, filename="maze.txt"):
                     row_str += "E"
                 elif maze[r][c] == 1:
                     row_str += "1"
+                elif weights is not None and weights[r][c] >= 2:
+                    row_str += str(min(weights[r][c], 9))
                 else:
                     row_str += "0"
             f.write(row_str + "\n")
@@ -168,13 +183,15 @@ def draw_maze_turtle(maze, cell_size=20, start_pos=None, end_pos=None):
 if __name__ == "__main__":
     maze_width = 21  # Must be odd for this algorithm
     maze_height = 11 # Must be odd for this algorithm
+    use_terrain = False  # Set True to write weighted cells (2-9) for the weighted solvers
     generated_maze = generate_maze(maze_width, maze_height)
     
     # Find start and end points
     start_pos, end_pos = find_start_end_points(generated_maze)
     
     # Save maze to file for C++ program
-    save_maze_to_file(generated_maze, "maze.txt")
+    terrain = generate_terrain(generated_maze) if use_terrain else None
+    save_maze_to_file(generated_maze, "maze.txt", terrain)
     
     # print_maze(generated_maze)  # Uncomment to also print in console
     draw_maze_turtle(generated_maze, cell_size=24, start_pos=start_pos, end_pos=end_pos)
\ No newline at end of file
@@ -0,0 +1,479 @@
+// maze_core.hpp - header-only grid search core shared by main.cpp, BFS.cpp,
+// custom.cpp and MazeSequentialIterator.cpp.
+//
+// One search loop, specialised at compile time by six policies:
+//   Nbr       neighbourhood: Four, or Eight<Corners::...> with its corner rule
+//   Cost      step cost: UnitCost, ByteCost (uint8_t per cell), WordCost (uint32_t)
+//   Grid      storage: anything with height()/width()/open(r,c). CharGrid wraps
+//             the text rows of maze.txt; main.cpp adapts its bit-packed grid
+//   Frontier  Fifo / Lifo (label on push: BFS, DFS), BinaryHeap (Dijkstra),
+//             Buckets (Dial's ring, for small integer costs)
+//   Labels    per-cell visited + direction: EpochLabels (a stamp word, O(1)
+//             reset, for repeated solves) or PackedLabels (3 bits, one-shot)
+//   Heuristic NoHeuristic, or StepDistance to turn a heap search into A*
+// Direction tables are constexpr and the neighbour loop is a fold over an
+// index sequence, so each instantiation compiles to straight-line code for its
+// neighbourhood with every policy test resolved at compile time. Loops that
+// cannot be phrased as one Search (bidirectional, jump point, graph searches)
+// keep their state in DistanceLabels, over the same labels. A search given a
+// maze_trace::TraceWriter streams its events to it (-DMAZE_NO_TRACE strips
+// the hooks).
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "maze_trace.hpp"
+
+namespace maze_core {
+
+// ---- Neighbourhoods -------------------------------------------------------------
+// Direction k moves by (dr[k], dc[k]); a search stores k per cell and walks
+// back against it, so parents need no cell ids.
+struct Four {
+    static constexpr int size = 4;
+    static constexpr std::array<int, 4> dr{-1, 0, 1, 0};    // up right down left
+    static constexpr std::array<int, 4> dc{0, 1, 0, -1};
+    static constexpr int reverse(int k) { return (k + 2) & 3; }
+    // Fewest steps between two cells on an open grid
+    static int distance(int r0, int c0, int r1, int c1) { return std::abs(r0 - r1) + std::abs(c0 - c1); }
+};
+
+// When a diagonal step may pass between its two orthogonal neighbours
+enum class Corners {
+    Cut,        // always; only the target cell must be open
+    OneOpen,    // at least one of the two is open
+    NoCut       // both are open
+};
+
+// 8-connected. A diagonal step costs the same as a straight one: the cost
+// policy charges for entering the target cell either way.
+template <Corners Rule>
+struct Eight {
+    static constexpr int size = 8;
+    static constexpr Corners corners = Rule;
+    static constexpr std::array<int, 8> dr{-1, -1, 0, 1, 1, 1, 0, -1};   // N NE E SE S SW W NW
+    static constexpr std::array<int, 8> dc{0, 1, 1, 1, 0, -1, -1, -1};
+    static constexpr int reverse(int k) { return (k + 4) & 7; }
+    static int distance(int r0, int c0, int r1, int c1) { return std::max(std::abs(r0 - r1), std::abs(c0 - c1)); }
+};
+
+// Calls f(integral_constant<int, K>) for K = 0..N-1, unrolled
+template <class F, int... K>
+inline void unrollImpl(F &&f, std::integer_sequence<int, K...>) { (f(std::integral_constant<int, K>{}), ...); }
+template <int N, class F>
+inline void unroll(F &&f) { unrollImpl(f, std::make_integer_sequence<int, N>{}); }
+
+// ---- Step costs ---------------------------------------------------------------------
+// cost(i) is the price of entering cell i; maxStep() bounds it (Dial's ring size)
+struct UnitCost {
+    static constexpr bool unit = true;
+    using dist_type = uint32_t;
+    constexpr uint32_t operator()(size_t) const { return 1; }
+    constexpr uint32_t maxStep() const { return 1; }
+};
+
+template <class T>
+struct WeightCost {
+    static constexpr bool unit = false;
+    using dist_type = std::conditional_t<(sizeof(T) < 4), uint32_t, uint64_t>;
+    const T *weight;            // row-major, one entry per cell
+    uint32_t maxWeight;
+    dist_type operator()(size_t i) const { return weight[i]; }
+    uint32_t maxStep() const { return maxWeight; }
+};
+using ByteCost = WeightCost<uint8_t>;
+using WordCost = WeightCost<uint32_t>;
+
+// ---- Grid storage -----------------------------------------------------------------
+// A grid policy provides height(), width() and open(r, c). It sets `padded`
+// when open() may be probed one cell outside the maze (reading wall), which
+// drops the bounds checks, and `masks` when neighbors(r, c) returns the four
+// open flags of Four's directions in one read.
+//
+// Text rows as read from maze.txt: '1' is wall, anything else open. Rows
+// shorter than the width read as wall past their end.
+struct CharGrid {
+    static constexpr bool padded = false, masks = false;
+    const std::vector<std::string> *rows;
+    int h, w;
+    int height() const { return h; }
+    int width() const { return w; }
+    bool open(int r, int c) const {
+        const std::string &row = (*rows)[size_t(r)];
+        return size_t(c) < row.size() && row[size_t(c)] != '1';
+    }
+};
+
+template <class Grid>
+inline bool openAt(const Grid &g, int r, int c) {
+    if constexpr (!Grid::padded)
+        if (r < 0 || c < 0 || r >= g.height() || c >= g.width()) return false;
+    return g.open(r, c);
+}
+
+// Whether the step from (r, c) in direction K is allowed
+template <class Nbr, int K, class Grid>
+inline bool canStep(const Grid &g, int r, int c) {
+    constexpr int dr = Nbr::dr[K], dc = Nbr::dc[K];
+    if (!openAt(g, r + dr, c + dc)) return false;
+    if constexpr (dr != 0 && dc != 0) {
+        if constexpr (Nbr::corners == Corners::OneOpen) return openAt(g, r + dr, c) || openAt(g, r, c + dc);
+        if constexpr (Nbr::corners == Corners::NoCut) return openAt(g, r + dr, c) && openAt(g, r, c + dc);
+    }
+    return true;
+}
+
+// ---- Frontiers ----------------------------------------------------------------------
+template <class D>
+struct Entry { D dist; uint32_t id; };
+
+// Label-on-push frontiers: a cell's first discovery is final, which is only
+// right for unit costs. They carry ids alone.
+template <class D>
+class Fifo {
+public:
+    static constexpr bool labelOnPush = true;
+    void reset(uint32_t) { q.clear(); head = 0; }
+    bool empty() const { return head == q.size(); }
+    void push(D, uint32_t id) { q.push_back(id); }
+    Entry<D> pop() { return {D{}, q[head++]}; }
+    size_t bytes() const { return q.capacity() * sizeof(uint32_t); }
+private:
+    std::vector<uint32_t> q;
+    size_t head = 0;
+};
+
+template <class D>
+class Lifo {
+public:
+    static constexpr bool labelOnPush = true;
+    void reset(uint32_t) { st.clear(); }
+    bool empty() const { return st.empty(); }
+    void push(D, uint32_t id) { st.push_back(id); }
+    Entry<D> pop() { const uint32_t id = st.back(); st.pop_back(); return {D{}, id}; }
+    size_t bytes() const { return st.capacity() * sizeof(uint32_t); }
+private:
+    std::vector<uint32_t> st;
+};
+
+// Heap key ordered by `key`, then by `tie`
+inline uint64_t tieKey(uint32_t key, uint32_t tie) { return uint64_t(key) << 32 | tie; }
+
+// Binary min-heap with lazy deletion: outdated entries are skipped on pop
+template <class D>
+class BinaryHeap {
+public:
+    static constexpr bool labelOnPush = false;
+    void reset(uint32_t = 0) { h.clear(); }
+    bool empty() const { return h.empty(); }
+    const Entry<D> &top() const { return h.front(); }
+    void push(D d, uint32_t id) { h.push_back({d, id}); std::push_heap(h.begin(), h.end(), later); }
+    Entry<D> pop() {
+        std::pop_heap(h.begin(), h.end(), later);
+        const Entry<D> e = h.back();
+        h.pop_back();
+        return e;
+    }
+    size_t bytes() const { return h.capacity() * sizeof(Entry<D>); }
+private:
+    std::vector<Entry<D>> h;
+    static bool later(const Entry<D> &a, const Entry<D> &b) { return a.dist > b.dist; }
+};
+
+// Dial's ring of maxStep + 1 buckets: every tentative distance lies within
+// maxStep of the one being popped, so push and pop are O(1). Steps must cost
+// at least 1, so a push never lands in the bucket being drained.
+template <class D>
+class Buckets {
+public:
+    static constexpr bool labelOnPush = false;
+    void reset(uint32_t maxStep) {
+        ring.resize(std::max<size_t>(ring.size(), size_t(maxStep) + 1));
+        for (auto &b : ring) b.clear();
+        slots = maxStep + 1; cur = 0; head = 0; pending = 0;
+    }
+    bool empty() const { return pending == 0; }
+    void push(D d, uint32_t id) { ring[size_t(d % slots)].push_back(id); ++pending; }
+    Entry<D> pop() {
+        for (;;) {
+            std::vector<uint32_t> &b = ring[size_t(cur % slots)];
+            if (head < b.size()) { --pending; return {cur, b[head++]}; }
+            b.clear(); head = 0; ++cur;
+        }
+    }
+    size_t bytes() const {
+        size_t n = ring.capacity() * sizeof(ring[0]);
+        for (const auto &b : ring) n += b.capacity() * sizeof(uint32_t);
+        return n;
+    }
+private:
+    std::vector<std::vector<uint32_t>> ring;
+    uint32_t slots = 1;
+    D cur{};
+    size_t head = 0, pending = 0;
+};
+
+// ---- Labels ----------------------------------------------------------------------
+// Which cells a search has reached and the direction k each was reached by
+// (cell = parent + (dr[k], dc[k])), so parents need no cell ids.
+//
+// One stamp word per cell: search epoch << (dirBits * Sides) | one direction
+// per side. Starting a search bumps the epoch instead of clearing, so a solve
+// costs O(1) to set up however large the buffers have grown; meant for
+// buffers reused across many solves. Two sides serve bidirectional searches.
+template <class Nbr, int Sides = 1>
+class EpochLabels {
+public:
+    static constexpr int sides = Sides;
+    static constexpr uint32_t dirBits = Nbr::size <= 4 ? 2 : 4;
+    static_assert(Nbr::size <= 16 && Sides >= 1 && dirBits * Sides <= 8, "directions are stored in the stamp's low 8 bits");
+
+    void begin(size_t cells) {
+        if (stamp.size() < cells) { stamp.assign(cells, 0); epoch = 0; }
+        if (++epoch == 1u << (32 - SHIFT)) { std::fill(stamp.begin(), stamp.end(), 0); epoch = 1; }
+    }
+    bool reached(size_t i) const { return stamp[i] >> SHIFT == epoch; }
+    // Sets side's direction; a cell new to this search has its other sides' cleared
+    void label(size_t i, int k, int side = 0) {
+        const uint32_t keep = reached(i) ? stamp[i] & ~(MASK << dirBits * side) & ((1u << SHIFT) - 1) : 0;
+        stamp[i] = epoch << SHIFT | keep | uint32_t(k) << dirBits * side;
+    }
+    int direction(size_t i, int side = 0) const { return int(stamp[i] >> dirBits * side & MASK); }   // where reached
+    size_t bytes() const { return stamp.capacity() * sizeof(uint32_t); }
+
+private:
+    static constexpr uint32_t SHIFT = dirBits * Sides, MASK = (1u << dirBits) - 1;
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+};
+
+// A visited bit plus a packed direction per cell: 3 bits for Four instead of
+// EpochLabels' 32. begin() clears the visited bits, O(cells / 64) per search,
+// which suits programs that solve one maze once.
+template <class Nbr>
+class PackedLabels {
+public:
+    static constexpr int sides = 1;
+    static constexpr uint32_t dirBits = Nbr::size <= 4 ? 2 : 4;   // a power of two, so no code straddles a word
+    static_assert(Nbr::size <= 16, "directions are stored in 4 bits");
+
+    void begin(size_t cells) {
+        seen.assign((cells + 63) / 64, 0);
+        dirs.resize((cells * dirBits + 63) / 64);
+    }
+    bool reached(size_t i) const { return seen[i >> 6] >> (i & 63) & 1; }
+    void label(size_t i, int k, int = 0) {
+        seen[i >> 6] |= uint64_t(1) << (i & 63);
+        const size_t b = i * dirBits;
+        dirs[b >> 6] = (dirs[b >> 6] & ~(MASK << (b & 63))) | uint64_t(k) << (b & 63);
+    }
+    int direction(size_t i, int = 0) const { const size_t b = i * dirBits; return int(dirs[b >> 6] >> (b & 63) & MASK); }
+    size_t bytes() const { return (seen.capacity() + dirs.capacity()) * sizeof(uint64_t); }
+
+private:
+    static constexpr uint64_t MASK = (uint64_t(1) << dirBits) - 1;
+    std::vector<uint64_t> seen, dirs;
+};
+
+// Labels plus one distance per side, for search loops written outside Search.
+// dist() reads `unset` on a side the current search has not reached.
+template <class D, class Labels>
+class DistanceLabels {
+public:
+    static constexpr int sides = Labels::sides;
+
+    void begin(size_t cells, D unsetDist) {
+        labels.begin(cells);
+        for (auto &d : dists) if (d.size() < cells) d.resize(cells);
+        unset = unsetDist;
+    }
+    bool reached(size_t i) const { return labels.reached(i); }       // on any side
+    D dist(size_t i, int side = 0) const { return labels.reached(i) ? dists[size_t(side)][i] : unset; }
+    int direction(size_t i, int side = 0) const { return labels.direction(i, side); }
+    void set(size_t i, D d, int k, int side = 0) {
+        if (!labels.reached(i)) for (auto &x : dists) x[i] = unset;
+        labels.label(i, k, side);
+        dists[size_t(side)][i] = d;
+    }
+    size_t bytes() const {
+        size_t n = labels.bytes();
+        for (const auto &d : dists) n += d.capacity() * sizeof(D);
+        return n;
+    }
+
+private:
+    Labels labels;
+    std::array<std::vector<D>, size_t(Labels::sides)> dists;
+    D unset{};
+};
+
+// ---- Heuristics -------------------------------------------------------------------
+// A heuristic makes a heap search A*: estimate<Nbr>(r, c, er, ec) must never
+// exceed the cost from (r, c) to (er, ec). The heap is keyed by f = g + h with
+// ties going to the smaller h, the cell nearer the goal, so on open areas the
+// search runs at the goal instead of flooding a whole f-layer.
+struct NoHeuristic { static constexpr bool active = false; };
+
+// Steps between the cells on an open grid; admissible while every step costs
+// at least 1, which every Cost policy here guarantees
+struct StepDistance {
+    static constexpr bool active = true;
+    template <class Nbr>
+    static uint32_t estimate(int r, int c, int er, int ec) { return uint32_t(Nbr::distance(r, c, er, ec)); }
+};
+
+// ---- Search -----------------------------------------------------------------------
+struct NoHook { void operator()(int, int) const {} };
+
+// Best-first search from one cell to another. The object only owns buffers,
+// so one Search serves any number of mazes and solves. Labels record each
+// cell's parent direction; distances are kept only where the frontier needs
+// them (not for Fifo / Lifo).
+template <class Nbr, class Cost, class Grid, template <class> class Frontier, class Labels = EpochLabels<Nbr>,
+          class Heuristic = NoHeuristic>
+class Search {
+public:
+    using dist_type = typename Cost::dist_type;
+    using key_type = std::conditional_t<Heuristic::active, uint64_t, dist_type>;    // A*: tieKey(f, h)
+    static constexpr bool labelOnPush = Frontier<key_type>::labelOnPush;
+    static_assert(!labelOnPush || Cost::unit, "Fifo and Lifo frontiers are only exact for unit costs");
+    static_assert(!Heuristic::active || (std::is_same_v<Frontier<key_type>, BinaryHeap<key_type>> && sizeof(dist_type) == 4),
+                  "A* needs the binary heap and 32-bit distances");
+
+    // Path from (sr, sc) to (er, ec) as P{row, col}, empty when there is none
+    // (or either end is a wall). onExpand(r, c) sees every cell taken off the
+    // frontier, in order; if it returns bool, false abandons the search.
+    template <class P, class OnExpand = NoHook>
+    std::vector<P> run(const Grid &grid, const Cost &cost, int sr, int sc, int er, int ec, OnExpand onExpand = {}) {
+        const int W = grid.width();
+        count = 0;
+        if (!openAt(grid, sr, sc) || !openAt(grid, er, ec)) return {};
+        begin(size_t(grid.height()) * size_t(W));
+        frontier.reset(cost.maxStep());
+        const uint32_t s = uint32_t(size_t(sr) * W + sc), e = uint32_t(size_t(er) * W + ec);
+        label(s, 0);
+        if constexpr (!labelOnPush) dist[s] = 0;
+        frontier.push(key(0, sr, sc, er, ec), s);
+        MAZE_TRACE_EVENT(tracer, Push, s);
+#ifdef MAZE_TRACE
+        size_t pushed = 1, levelEnd = 0;             // Fifo: a level ends once every cell pushed before it is out
+        uint32_t level = 0;
+        dist_type lastDist{};
+#endif
+        while (!frontier.empty()) {
+            const Entry<key_type> cur = frontier.pop();
+            if constexpr (!labelOnPush) if (gOf(cur.dist) != dist[cur.id]) continue;
+#ifdef MAZE_TRACE
+            if (tracer) {
+                if constexpr (std::is_same_v<Frontier<dist_type>, Fifo<dist_type>>) {
+                    if (count == levelEnd) { tracer->level(level++); levelEnd = pushed; }
+                } else if constexpr (!labelOnPush) {
+                    if (count == 0 || fOf(cur.dist) != lastDist) { lastDist = fOf(cur.dist); tracer->level(uint32_t(lastDist)); }
+                }
+                tracer->expand(cur.id);
+            }
+#endif
+            ++count;
+            const int r = int(cur.id / uint32_t(W)), c = int(cur.id % uint32_t(W));
+            if constexpr (std::is_same_v<decltype(onExpand(r, c)), bool>) { if (!onExpand(r, c)) return {}; }
+            else onExpand(r, c);
+            if (cur.id == e) break;
+            unsigned mask = 0;
+            if constexpr (Grid::masks && Nbr::size == 4) mask = grid.neighbors(r, c);
+            unroll<Nbr::size>([&](auto K) {
+                constexpr int k = decltype(K)::value;
+                if constexpr (Grid::masks && Nbr::size == 4) { if (!(mask >> k & 1)) return; }
+                else if (!canStep<Nbr, k>(grid, r, c)) return;
+                const uint32_t v = uint32_t(int64_t(cur.id) + int64_t(Nbr::dr[k]) * W + Nbr::dc[k]);
+                if constexpr (labelOnPush) {
+                    if (reached(v)) return;
+                    label(v, k);
+                    frontier.push(key_type{}, v);
+#ifdef MAZE_TRACE
+                    ++pushed;
+#endif
+                    MAZE_TRACE_EVENT(tracer, Push, v);
+                } else {
+                    const dist_type nd = dist[cur.id] + cost(v);
+                    if (reached(v) && dist[v] <= nd) return;
+                    label(v, k);
+                    dist[v] = nd;
+                    frontier.push(key(nd, r + Nbr::dr[k], c + Nbr::dc[k], er, ec), v);
+                    MAZE_TRACE_EVENT(tracer, Push, v);
+                }
+            });
+        }
+        if (!reached(e)) return {};
+        return trace<P>(e, s, W);
+    }
+
+    bool reached(size_t i) const { return labels.reached(i); }
+    dist_type distance(size_t i) const { return dist[i]; }        // where reached; not for Fifo / Lifo
+    int direction(size_t i) const { return labels.direction(i); }
+    size_t expanded() const { return count; }
+    size_t bytes() const { return labels.bytes() + dist.capacity() * sizeof(dist_type) + frontier.bytes(); }
+#ifdef MAZE_TRACE
+    // Streams the following runs' expansions, pushes and level boundaries
+    // (BFS depth or Dijkstra distance) to `t`; null turns tracing off
+    void setTrace(maze_trace::TraceWriter *t) { tracer = t; }
+#endif
+
+private:
+    Labels labels;
+    std::vector<dist_type> dist;
+    Frontier<key_type> frontier;
+    size_t count = 0;
+#ifdef MAZE_TRACE
+    maze_trace::TraceWriter *tracer = nullptr;
+#endif
+
+    void begin(size_t cells) {
+        labels.begin(cells);
+        if constexpr (!labelOnPush) if (dist.size() < cells) dist.resize(cells);
+    }
+    void label(size_t i, int k) { labels.label(i, k); }
+    // Frontier key of (r, c) at distance g, and g and f = g + h back from a key
+    static key_type key(dist_type g, int r, int c, int er, int ec) {
+        if constexpr (Heuristic::active) {
+            const uint32_t h = Heuristic::template estimate<Nbr>(r, c, er, ec);
+            return tieKey(uint32_t(g) + h, h);
+        } else {
+            (void)r; (void)c; (void)er; (void)ec;
+            return g;
+        }
+    }
+    static dist_type gOf(key_type k) {
+        if constexpr (Heuristic::active) return dist_type(uint32_t(k >> 32) - uint32_t(k));
+        else return k;
+    }
+    static dist_type fOf(key_type k) {
+        if constexpr (Heuristic::active) return dist_type(k >> 32);
+        else return k;
+    }
+    size_t back(size_t x, int W) const {
+        const int k = direction(x);
+        return size_t(int64_t(x) - (int64_t(Nbr::dr[k]) * W + Nbr::dc[k]));
+    }
+    // Counts the cells first so the path is the walk's only allocation
+    template <class P>
+    std::vector<P> trace(size_t at, size_t root, int W) const {
+        size_t n = 1;
+        for (size_t x = at; x != root; ++n) x = back(x, W);
+        std::vector<P> path(n);
+        for (size_t x = at;; x = back(x, W)) {
+            path[--n] = P{int(x / size_t(W)), int(x % size_t(W))};
+            if (x == root) break;
+        }
+        return path;
+    }
+};
+
+} // namespace maze_core
@@ -0,0 +1,213 @@
+// maze_trace.hpp - header-only search trace: a solver streams its expansions,
+// frontier pushes and level boundaries into a fixed-size ring buffer, and a
+// background thread drains the ring into a compact binary file. Memory stays
+// at the ring's size however much of the maze the search explores, and the
+// searching thread never touches the file.
+//
+// The solver hooks (MAZE_TRACE_EVENT, maze_core::Search::setTrace) are
+// compiled in and switched on at run time by handing a search a writer; with
+// no writer each costs a never-taken branch. -DMAZE_NO_TRACE strips them.
+//
+// File (.mzt), little-endian:
+//   "MZT1", uint32 height, uint32 width, uint32 reserved
+//   then one LEB128 varint per event, v = payload << 2 | type:
+//     Expand / Push  payload = zigzag(cell - previous Expand/Push cell)
+//     Level          payload = level (BFS depth, or distance for Dijkstra)
+//     End            payload = number of events before it; absent = truncated
+// Cells are row-major ids r * width + c.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace maze_trace {
+
+enum Event : uint32_t { Expand = 0, Push = 1, Level = 2, End = 3 };
+
+static const char MAGIC[4] = {'M', 'Z', 'T', '1'};
+
+inline uint64_t zigzag(int64_t v) { return uint64_t(v) << 1 ^ uint64_t(v >> 63); }
+inline int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+// Single producer (the searching thread), single consumer (the writer thread).
+// emit() is a slot store plus a release store of the tail; it only waits when
+// the writer has fallen a whole ring behind.
+class TraceWriter {
+public:
+    TraceWriter(const std::string &path, uint32_t height, uint32_t width, size_t capacity = size_t(1) << 16)
+        : ring(roundUp(capacity)), mask(ring.size() - 1) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return;
+        const uint32_t head4[3] = {height, width, 0};
+        failed = std::fwrite(MAGIC, 1, 4, file) != 4 || std::fwrite(head4, 4, 3, file) != 3;
+        written = 16;
+        worker = std::thread([this] { drain(); });
+    }
+    ~TraceWriter() { close(); }
+    TraceWriter(const TraceWriter &) = delete;
+    TraceWriter &operator=(const TraceWriter &) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    void emit(Event type, uint32_t value) {
+        if (!file) return;
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headSeen == ring.size())
+            while (t - (headSeen = head.load(std::memory_order_acquire)) == ring.size()) std::this_thread::yield();
+        ring[t & mask] = uint64_t(value) << 2 | type;
+        tail.store(t + 1, std::memory_order_release);
+    }
+    void expand(uint32_t cell) { emit(Expand, cell); }
+    void push(uint32_t cell) { emit(Push, cell); }
+    void level(uint32_t n) { emit(Level, n); }
+
+    // Drains the ring, writes the end marker and closes the file
+    bool close() {
+        if (!file) return false;
+        done.store(true, std::memory_order_release);
+        worker.join();
+        failed |= std::fclose(file) != 0;
+        file = nullptr;
+        return !failed;
+    }
+    uint64_t events() const { return count; }      // after close()
+    uint64_t bytes() const { return written; }
+
+private:
+    std::vector<uint64_t> ring;
+    size_t mask;
+    std::FILE *file = nullptr;
+    std::thread worker;
+    std::atomic<size_t> head{0}, tail{0};
+    std::atomic<bool> done{false};
+    size_t headSeen = 0;                             // producer's last look at head
+    // writer thread only
+    std::vector<uint8_t> out;
+    uint32_t prev = 0;
+    uint64_t count = 0, written = 0;
+    bool failed = false;
+
+    static size_t roundUp(size_t n) {
+        size_t p = 1024;
+        while (p < n) p <<= 1;
+        return p;
+    }
+    void varint(uint64_t v) {
+        while (v >= 0x80) { out.push_back(uint8_t(v | 0x80)); v >>= 7; }
+        out.push_back(uint8_t(v));
+    }
+    void flush() {
+        failed |= std::fwrite(out.data(), 1, out.size(), file) != out.size();
+        written += out.size();
+        out.clear();
+    }
+    void drain() {
+        out.reserve(size_t(1) << 16);
+        for (;;) {
+            const bool last = done.load(std::memory_order_acquire);
+            const size_t t = tail.load(std::memory_order_acquire);
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == t) {
+                if (last) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            for (; h != t; ++h) {
+                const uint64_t rec = ring[h & mask];
+                const uint32_t type = uint32_t(rec & 3), value = uint32_t(rec >> 2);
+                if (type == Level) varint(uint64_t(value) << 2 | type);
+                else { varint(zigzag(int64_t(value) - int64_t(prev)) << 2 | type); prev = value; }
+                ++count;
+                if (out.size() >= (size_t(1) << 16) - 16) flush();
+            }
+            head.store(h, std::memory_order_release);
+        }
+        varint(count << 2 | End);
+        flush();
+    }
+};
+
+// Reads a trace back event by event, e.g. to replay a search
+class TraceReader {
+public:
+    explicit TraceReader(const std::string &path) {
+        file = std::fopen(path.c_str(), "rb");
+        if (!file) return;
+        char magic[4];
+        uint32_t head4[3];
+        if (std::fread(magic, 1, 4, file) != 4 || std::memcmp(magic, MAGIC, 4) != 0 ||
+            std::fread(head4, 4, 3, file) != 3) { std::fclose(file); file = nullptr; return; }
+        height = head4[0]; width = head4[1];
+        buf.resize(size_t(1) << 16);
+    }
+    ~TraceReader() { if (file) std::fclose(file); }
+    TraceReader(const TraceReader &) = delete;
+    TraceReader &operator=(const TraceReader &) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+    // Next event (Expand / Push carry the cell id, Level the level); false at
+    // the end marker or the end of the file
+    bool next(Event &type, uint32_t &value) {
+        uint64_t v;
+        if (ended || !varint(v)) return false;
+        type = Event(v & 3);
+        if (type == End) { ended = true; complete = (v >> 2) == count; return false; }
+        if (type == Level) value = uint32_t(v >> 2);
+        else value = prev = uint32_t(int64_t(prev) + unzigzag(v >> 2));
+        ++count;
+        return true;
+    }
+    // True once next() has reached an end marker matching the events read
+    bool isComplete() const { return complete; }
+
+    uint32_t height = 0, width = 0;
+
+private:
+    std::FILE *file = nullptr;
+    std::vector<uint8_t> buf;
+    size_t pos = 0, len = 0;
+    uint32_t prev = 0;
+    uint64_t count = 0;
+    bool ended = false, complete = false;
+
+    bool byte(uint8_t &b) {
+        if (pos == len) {
+            len = file ? std::fread(buf.data(), 1, buf.size(), file) : 0;
+            pos = 0;
+            if (!len) return false;
+        }
+        b = buf[pos++];
+        return true;
+    }
+    bool varint(uint64_t &v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b;
+            if (!byte(b)) return false;
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+};
+
+} // namespace maze_trace
+
+// Trace hook for solver loops: `writer` is a TraceWriter* (null = off).
+// MAZE_TRACE is defined unless the build opts out with MAZE_NO_TRACE, in which
+// case the hook expands to nothing.
+#if !defined(MAZE_TRACE) && !defined(MAZE_NO_TRACE)
+#define MAZE_TRACE
+#endif
+#ifdef MAZE_TRACE
+#define MAZE_TRACE_EVENT(writer, type, value) \
+    do { if (writer) (writer)->emit(maze_trace::type, uint32_t(value)); } while (0)
+#else
+#define MAZE_TRACE_EVENT(writer, type, value) do {} while (0)
+#endif
@@ -0,0 +1,480 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Seeded maze generator for benchmarking the solvers in main.cpp.
+// Usage: mazegen HEIGHT WIDTH [--algo eller|backtracker|kruskal|prim|wilson]
+//                [--seed N] [--braid P] [--rooms N] [--terrain RATIO] [--out maze.txt|maze.mzb]
+//
+// Passages are carved on the lattice of odd cells, exactly like maze.py:
+// lattice cell (i, j) is grid cell (2i+1, 2j+1) and the cell between two
+// lattice neighbours is opened to join them. Grid rows are assembled and
+// written one at a time, so output never holds the whole maze as text.
+//   eller        streams: O(width) memory, the choice for huge mazes
+//   backtracker  recursive backtracker (maze.py's algorithm), long corridors
+//   kruskal      randomised Kruskal with union-find
+//   prim         randomised Prim
+//   wilson       loop-erased random walks, uniform spanning tree (slow start)
+// The in-memory algorithms keep one byte per lattice cell plus their own
+// bookkeeping. --braid opens each remaining lattice wall with probability P
+// (loops), --rooms carves N rectangular rooms, --terrain gives that fraction
+// of open cells a cost of 2-9. Output is maze.txt format or, for a .mzb
+// name, main.cpp's binary format written section by section.
+//
+// Nothing is ever opened outside the lattice box, so find_start_end_points'
+// rule (first open cell from the top-left, last from the bottom-right)
+// always yields S = (1, 1) and E = (last odd row, last odd column).
+
+// splitmix64: deterministic on every platform, unlike <random>'s distributions
+struct Rng {
+    uint64_t s, bits = 0;
+    int left = 0;
+    explicit Rng(uint64_t seed) : s(seed) {}
+    uint64_t next() {
+        uint64_t z = (s += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return uint32_t(((next() >> 32) * n) >> 32); }
+    bool chance(double p) { return double(next() >> 11) * 0x1.0p-53 < p; }
+    bool coin() {
+        if (!left) { bits = next(); left = 64; }
+        --left;
+        bool b = bits & 1; bits >>= 1;
+        return b;
+    }
+};
+
+// Lattice rows: bit 0 = open to the right neighbour, bit 1 = open downwards
+static const uint8_t RIGHT = 1, DOWN = 2;
+
+struct LatticeSource {
+    virtual ~LatticeSource() {}
+    virtual void row(int i, uint8_t *pass) = 0;   // called for i = 0..R-1 in order
+};
+
+// Eller's algorithm in the classic two-array form: each set of the current
+// row is a circular doubly linked list of its columns (L/R). Sets in a row
+// never interleave, so column c+1 shares c's set exactly when L[c+1] == c and
+// every step is O(1). A cell that gets a wall below leaves its set and starts
+// a new one in the next row; the last member of a set always goes down.
+class EllerSource : public LatticeSource {
+public:
+    EllerSource(int R, int C, Rng &rng) : R(R), C(C), rng(rng), L(C), Rt(C) {
+        iota(L.begin(), L.end(), 0);
+        iota(Rt.begin(), Rt.end(), 0);
+    }
+    void row(int i, uint8_t *pass) override {
+        const bool last = i == R - 1;
+        // uint8_t stores may alias anything, so work on locals
+        Rng g = rng;
+        int *L = this->L.data(), *R = this->Rt.data();
+        for (int c = 0; c < C; ++c) {
+            uint8_t p = 0;
+            // the last row joins everything that is still apart
+            if (c + 1 < C && L[c + 1] != c && (last || g.coin())) {
+                R[L[c + 1]] = R[c]; L[R[c]] = L[c + 1];
+                R[c] = c + 1; L[c + 1] = c;
+                p = RIGHT;
+            }
+            if (!last) {
+                if (L[c] != c && g.coin()) { R[L[c]] = R[c]; L[R[c]] = L[c]; R[c] = L[c] = c; }
+                else p |= DOWN;
+            }
+            pass[c] = p;
+        }
+        rng = g;
+    }
+private:
+    int R, C;
+    Rng &rng;
+    vector<int> L, Rt;
+};
+
+// Whole-lattice algorithms carve into `pass` (one byte per lattice cell)
+class InMemorySource : public LatticeSource {
+public:
+    InMemorySource(int R, int C) : R(R), C(C), pass(size_t(R) * C, 0) {}
+    void row(int i, uint8_t *out) override { memcpy(out, &pass[size_t(i) * C], C); }
+
+    void backtracker(Rng &rng) {
+        vector<bool> seen(pass.size(), false);
+        vector<uint32_t> stack{uint32_t(rng.below(uint32_t(pass.size())))};
+        seen[stack[0]] = true;
+        uint32_t options[4];
+        while (!stack.empty()) {
+            const uint32_t u = stack.back();
+            int n = 0;
+            for (uint32_t v : neighbours(u)) if (v != NONE && !seen[v]) options[n++] = v;
+            if (!n) { stack.pop_back(); continue; }
+            const uint32_t v = options[rng.below(n)];
+            carve(u, v); seen[v] = true; stack.push_back(v);
+        }
+    }
+
+    void kruskal(Rng &rng) {
+        // wall w joins cell w/2 with its right (w even) or lower (w odd) neighbour
+        vector<uint32_t> walls;
+        walls.reserve(pass.size() * 2);
+        for (uint32_t u = 0; u < pass.size(); ++u) {
+            if (int(u % C) + 1 < C) walls.push_back(u * 2);
+            if (int(u / C) + 1 < R) walls.push_back(u * 2 + 1);
+        }
+        for (size_t k = walls.size(); k > 1; --k) swap(walls[k - 1], walls[rng.below(uint32_t(k))]);
+        vector<uint32_t> parent(pass.size());
+        iota(parent.begin(), parent.end(), 0u);
+        auto find = [&](uint32_t x) { while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; } return x; };
+        for (uint32_t w : walls) {
+            const uint32_t u = w / 2, v = w & 1 ? u + C : u + 1;
+            const uint32_t a = find(u), b = find(v);
+            if (a != b) { parent[a] = b; carve(u, v); }
+        }
+    }
+
+    void prim(Rng &rng) {
+        vector<bool> in(pass.size(), false);
+        vector<pair<uint32_t,uint32_t>> frontier;   // (cell in the maze, cell outside)
+        auto add = [&](uint32_t u) {
+            in[u] = true;
+            for (uint32_t v : neighbours(u)) if (v != NONE && !in[v]) frontier.push_back({u, v});
+        };
+        add(rng.below(uint32_t(pass.size())));
+        while (!frontier.empty()) {
+            const size_t k = rng.below(uint32_t(frontier.size()));
+            const auto e = frontier[k];
+            frontier[k] = frontier.back(); frontier.pop_back();
+            if (in[e.second]) continue;
+            carve(e.first, e.second);
+            add(e.second);
+        }
+    }
+
+    void wilson(Rng &rng) {
+        vector<bool> in(pass.size(), false);
+        vector<uint8_t> exitDir(pass.size());
+        in[rng.below(uint32_t(pass.size()))] = true;
+        for (uint32_t start = 0; start < pass.size(); ++start) {
+            if (in[start]) continue;
+            // random walk until it hits the tree; later exits overwrite earlier
+            // ones, which erases the loops
+            for (uint32_t u = start; !in[u]; ) {
+                const auto nb = neighbours(u);
+                int k;
+                do k = int(rng.below(4)); while (nb[k] == NONE);
+                exitDir[u] = uint8_t(k);
+                u = nb[k];
+            }
+            for (uint32_t u = start; !in[u]; ) {
+                const uint32_t v = neighbours(u)[exitDir[u]];
+                carve(u, v); in[u] = true; u = v;
+            }
+        }
+    }
+
+private:
+    static const uint32_t NONE = UINT32_MAX;
+    int R, C;
+    vector<uint8_t> pass;
+    array<uint32_t,4> neighbours(uint32_t u) const {
+        const int i = int(u / C), j = int(u % C);
+        return {i > 0 ? u - C : NONE, j + 1 < C ? u + 1 : NONE, i + 1 < R ? u + C : NONE, j > 0 ? u - 1 : NONE};
+    }
+    void carve(uint32_t u, uint32_t v) {
+        if (u > v) swap(u, v);
+        pass[u] |= v == u + 1 ? RIGHT : DOWN;
+    }
+};
+
+struct Room { int r0, c0, r1, c1; };
+
+// Turns lattice rows into grid rows: 0 = wall, otherwise the entry cost
+class GridRows {
+public:
+    GridRows(int H, int W, LatticeSource &src, double braid, vector<Room> rooms, double terrain, uint64_t seed)
+        : H(H), W(W), R(((H - 3) | 1) / 2 + 1), C(((W - 3) | 1) / 2 + 1), src(src), braid(braid), terrain(terrain),
+          rooms(std::move(rooms)), braidRng(seed ^ 0x62726169640aull), terrainRng(seed ^ 0x7465727261696eull), pass(C) {
+        sort(this->rooms.begin(), this->rooms.end(), [](const Room &a, const Room &b) { return a.r0 < b.r0; });
+    }
+    int lastRow() const { return 2 * R - 1; }
+    int lastCol() const { return 2 * C - 1; }
+
+    void next(int r, vector<uint8_t> &cells) {
+        cells.assign(W, 0);
+        if (r > 0 && r <= lastRow()) {
+            if (r & 1) {
+                const int i = r / 2;
+                src.row(i, pass.data());
+                if (braid > 0)
+                    for (int j = 0; j < C; ++j) {
+                        if (j + 1 < C && !(pass[j] & RIGHT) && braidRng.chance(braid)) pass[j] |= RIGHT;
+                        if (i + 1 < R && !(pass[j] & DOWN) && braidRng.chance(braid)) pass[j] |= DOWN;
+                    }
+                for (int j = 0; j < C; ++j) {
+                    cells[2 * j + 1] = 1;
+                    if (pass[j] & RIGHT) cells[2 * j + 2] = 1;
+                }
+            } else {
+                for (int j = 0; j < C; ++j) if (pass[j] & DOWN) cells[2 * j + 1] = 1;
+            }
+            while (nextRoom < rooms.size() && rooms[nextRoom].r0 <= r) active.push_back(rooms[nextRoom++]);
+            active.erase(remove_if(active.begin(), active.end(), [&](const Room &m) { return m.r1 < r; }), active.end());
+            for (const Room &m : active) fill(cells.begin() + m.c0, cells.begin() + m.c1 + 1, 1);
+        }
+        if (terrain > 0)
+            for (int c = 0; c < W; ++c)
+                if (cells[c] && terrainRng.chance(terrain)) cells[c] = uint8_t(2 + terrainRng.below(8));
+        // S and E always cost 1, as in the text format
+        if (r == 1) cells[1] = 1;
+        if (r == lastRow()) cells[lastCol()] = 1;
+    }
+
+private:
+    int H, W, R, C;
+    LatticeSource &src;
+    double braid, terrain;
+    vector<Room> rooms, active;
+    size_t nextRoom = 0;
+    Rng braidRng, terrainRng;
+    vector<uint8_t> pass;
+};
+
+static vector<Room> makeRooms(int count, int lastRow, int lastCol, Rng &rng) {
+    vector<Room> rooms;
+    for (int k = 0; k < count; ++k) {
+        Room m;
+        m.r0 = 2 * int(rng.below(uint32_t(lastRow / 2 + 1))) + 1;
+        m.c0 = 2 * int(rng.below(uint32_t(lastCol / 2 + 1))) + 1;
+        m.r1 = min(lastRow, m.r0 + 2 * int(rng.below(6)) + 2);
+        m.c1 = min(lastCol, m.c0 + 2 * int(rng.below(6)) + 2);
+        rooms.push_back(m);
+    }
+    return rooms;
+}
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#else
+#define fseek64 fseeko
+#endif
+
+// maze.txt format
+class TextWriter {
+public:
+    TextWriter(FILE *f, int H, int W, int er, int ec) : f(f), er(er), ec(ec), line(W + 1) {
+        fprintf(f, "%d %d\n%d %d\n%d %d\n", H, W, 1, 1, er, ec);
+        line[W] = '\n';
+    }
+    void row(int r, const vector<uint8_t> &cells) {
+        static const char CH[10] = {'1', '0', '2', '3', '4', '5', '6', '7', '8', '9'};
+        for (size_t c = 0; c < cells.size(); ++c) line[c] = CH[cells[c]];
+        if (r == er) line[ec] = 'E';
+        if (r == 1) line[1] = 'S';                   // S wins on a 3x3 maze, as in maze.py
+        fwrite(line.data(), 1, line.size(), f);
+    }
+    bool finish() { return fflush(f) == 0; }
+private:
+    FILE *f;
+    int er, ec;
+    vector<char> line;
+};
+
+// main.cpp's .mzb layout (see MzbHeader there). The bits, neighbour-mask and
+// weight sections live at offsets known up front, so each gets its own FILE*
+// and is written sequentially; the header goes in last, once maxCost is known.
+struct MzbHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t height, width, sr, sc, er, ec;
+    uint32_t wordsPerRow, flags, maxCost, reserved;
+    uint64_t nbrOffset, weightOffset;
+};
+static_assert(sizeof(MzbHeader) == 64, "MzbHeader must stay 64 bytes");
+
+class MzbWriter {
+public:
+    MzbWriter(const string &path, int H, int W, int er, int ec, bool weighted) : W(W), weighted(weighted) {
+        h = MzbHeader{};
+        memcpy(h.magic, "MZB1", 4);
+        h.version = 1;
+        h.height = H; h.width = W;
+        h.sr = 1; h.sc = 1; h.er = er; h.ec = ec;
+        h.wordsPerRow = uint32_t(((W + 2 + 63) / 64 + 7) & ~7);
+        h.flags = weighted ? 1 : 0;
+        h.maxCost = 1;
+        h.nbrOffset = align64(sizeof(MzbHeader) + uint64_t(H + 2) * h.wordsPerRow * 8);
+        h.weightOffset = align64(h.nbrOffset + (uint64_t(H) * W + 1) / 2);
+        fBits = fopen(path.c_str(), "wb");
+        fNbr = fBits ? fopen(path.c_str(), "r+b") : nullptr;
+        fWeight = fNbr && weighted ? fopen(path.c_str(), "r+b") : nullptr;
+        ok = fNbr && (!weighted || fWeight);
+        if (!ok) return;
+        words.assign(h.wordsPerRow, 0);
+        fwrite(&h, sizeof h, 1, fBits);
+        fwrite(words.data(), 8, words.size(), fBits);            // top padding row
+        fseek64(fNbr, int64_t(h.nbrOffset), SEEK_SET);
+        if (fWeight) fseek64(fWeight, int64_t(h.weightOffset), SEEK_SET);
+    }
+    ~MzbWriter() { for (FILE *f : {fBits, fNbr, fWeight}) if (f) fclose(f); }
+    bool good() const { return ok; }
+
+    void row(int r, const vector<uint8_t> &cells) {
+        // open flags padded with a wall column on each side
+        down.assign(W + 2, 0);
+        for (int c = 0; c < W; ++c) down[c + 1] = cells[c] != 0;
+        fill(words.begin(), words.end(), 0);
+        for (int c = 0; c < W + 2; ++c) words[size_t(c) >> 6] |= uint64_t(down[c]) << (c & 63);
+        fwrite(words.data(), 8, words.size(), fBits);
+        if (weighted) {
+            weights.resize(W);
+            for (int c = 0; c < W; ++c) { weights[c] = cells[c] ? cells[c] : 1; h.maxCost = max<uint32_t>(h.maxCost, weights[c]); }
+            fwrite(weights.data(), 1, W, fWeight);
+        }
+        // masks of the previous row are complete once the row below is known
+        if (r > 0) masks();
+        up.swap(cur); cur.swap(down);
+    }
+
+    bool finish() {
+        if (!ok) return false;
+        down.assign(W + 2, 0);
+        masks();
+        if (half) fputc(pending, fNbr);
+        fill(words.begin(), words.end(), 0);
+        fwrite(words.data(), 8, words.size(), fBits);            // bottom padding row
+        if (h.maxCost == 1) h.flags = 0;                        // no cell drew a cost: same as the text loader
+        fseek64(fBits, 0, SEEK_SET);
+        fwrite(&h, sizeof h, 1, fBits);
+        bool good = true;
+        for (FILE *f : {fBits, fNbr, fWeight}) if (f && (ferror(f) || fflush(f) != 0)) good = false;
+        return good;
+    }
+
+private:
+    int W;
+    bool weighted, ok = false, half = false;
+    MzbHeader h;
+    FILE *fBits = nullptr, *fNbr = nullptr, *fWeight = nullptr;
+    vector<uint64_t> words;
+    vector<uint8_t> up, cur, down, weights, nbrOut;   // padded open flags of three rows
+    uint8_t pending = 0;
+    static uint64_t align64(uint64_t x) { return (x + 63) & ~uint64_t(63); }
+
+    // Neighbour masks for `cur` (bit k = up/right/down/left open), two per byte
+    void masks() {
+        if (up.empty()) up.assign(W + 2, 0);
+        nbrOut.clear();
+        int c = 0;
+        if (half) { nbrOut.push_back(uint8_t(pending | mask(0) << 4)); c = 1; half = false; }
+        for (; c + 1 < W; c += 2) nbrOut.push_back(uint8_t(mask(c) | mask(c + 1) << 4));
+        if (c < W) { pending = mask(c); half = true; }
+        fwrite(nbrOut.data(), 1, nbrOut.size(), fNbr);
+    }
+    uint8_t mask(int c) const {
+        const unsigned m = up[c + 1] | cur[c + 2] << 1 | down[c + 1] << 2 | cur[c] << 3;
+        return uint8_t(m & -unsigned(cur[c + 1]));
+    }
+};
+
+// Grid rows are produced on a second thread and handed over in blocks, so
+// generation overlaps with encoding and writing on multi-core machines.
+template <class Writer>
+static void pump(GridRows &rows, int H, Writer &out) {
+    const int BLOCK = 64, DEPTH = 4;
+    struct Block { int first = 0, count = 0; vector<vector<uint8_t>> rows; };
+    vector<Block> blocks(DEPTH);
+    deque<Block*> freeBlocks, fullBlocks;
+    for (auto &b : blocks) { b.rows.resize(BLOCK); freeBlocks.push_back(&b); }
+    mutex mu;
+    condition_variable cv;
+    auto take = [&](deque<Block*> &q) {
+        unique_lock<mutex> lk(mu);
+        cv.wait(lk, [&] { return !q.empty(); });
+        Block *b = q.front(); q.pop_front();
+        return b;
+    };
+    auto give = [&](deque<Block*> &q, Block *b) {
+        { lock_guard<mutex> lk(mu); q.push_back(b); }
+        cv.notify_all();
+    };
+    thread producer([&] {
+        for (int r = 0; r < H; r += BLOCK) {
+            Block *b = take(freeBlocks);
+            b->first = r; b->count = min(BLOCK, H - r);
+            for (int k = 0; k < b->count; ++k) rows.next(r + k, b->rows[k]);
+            give(fullBlocks, b);
+        }
+    });
+    for (int r = 0; r < H; ) {
+        Block *b = take(fullBlocks);
+        for (int k = 0; k < b->count; ++k) out.row(b->first + k, b->rows[k]);
+        r += b->count;
+        give(freeBlocks, b);
+    }
+    producer.join();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " HEIGHT WIDTH [--algo eller|backtracker|kruskal|prim|wilson]"
+             << " [--seed N] [--braid P] [--rooms N] [--terrain RATIO] [--out maze.txt|maze.mzb]\n";
+        return 1;
+    }
+    const int H = atoi(argv[1]), W = atoi(argv[2]);
+    string algo = "eller", outPath = "maze.txt";
+    uint64_t seed = 1;
+    double braid = 0, terrain = 0;
+    int roomCount = 0;
+    for (int i = 3; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--algo" && i + 1 < argc) algo = argv[++i];
+        else if (a == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (a == "--braid" && i + 1 < argc) braid = atof(argv[++i]);
+        else if (a == "--rooms" && i + 1 < argc) roomCount = max(0, atoi(argv[++i]));
+        else if (a == "--terrain" && i + 1 < argc) terrain = atof(argv[++i]);
+        else if (a == "--out" && i + 1 < argc) outPath = argv[++i];
+        else { cerr << "Unknown option " << a << '\n'; return 1; }
+    }
+    if (H < 3 || W < 3) { cerr << "Maze must be at least 3x3\n"; return 1; }
+
+    auto t0 = chrono::steady_clock::now();
+    const int R = ((H - 3) | 1) / 2 + 1, C = ((W - 3) | 1) / 2 + 1;
+    Rng rng(seed);
+    unique_ptr<LatticeSource> src;
+    if (algo == "eller") src.reset(new EllerSource(R, C, rng));
+    else {
+        if (uint64_t(R) * C >= UINT32_MAX) { cerr << "Too large for --algo " << algo << "; use eller\n"; return 1; }
+        auto *mem = new InMemorySource(R, C);
+        src.reset(mem);
+        if (algo == "backtracker") mem->backtracker(rng);
+        else if (algo == "kruskal") mem->kruskal(rng);
+        else if (algo == "prim") mem->prim(rng);
+        else if (algo == "wilson") mem->wilson(rng);
+        else { cerr << "Unknown algorithm " << algo << '\n'; return 1; }
+    }
+    Rng roomRng(seed ^ 0x726f6f6d73ull);
+    GridRows rows(H, W, *src, braid, makeRooms(roomCount, 2 * R - 1, 2 * C - 1, roomRng), terrain, seed);
+    const int er = rows.lastRow(), ec = rows.lastCol();
+
+    const bool binary = outPath.size() > 4 && outPath.compare(outPath.size() - 4, 4, ".mzb") == 0;
+    bool ok;
+    if (binary) {
+        MzbWriter out(outPath, H, W, er, ec, terrain > 0);
+        if (!out.good()) { cerr << "Could not open " << outPath << '\n'; return 1; }
+        pump(rows, H, out);
+        ok = out.finish();
+    } else {
+        FILE *f = fopen(outPath.c_str(), "wb");
+        if (!f) { cerr << "Could not open " << outPath << '\n'; return 1; }
+        static char buf[1 << 20];
+        setvbuf(f, buf, _IOFBF, sizeof buf);
+        TextWriter out(f, H, W, er, ec);
+        pump(rows, H, out);
+        ok = out.finish();
+        fclose(f);
+    }
+    if (!ok) { cerr << "Failed writing " << outPath << '\n'; return 1; }
+    auto t1 = chrono::steady_clock::now();
+    cout << "Generated " << H << "x" << W << " (" << algo << ", seed " << seed << ") in "
+         << chrono::duration_cast<chrono::milliseconds>(t1 - t0).count() << " ms -> " << outPath << '\n';
+    return 0;
+}
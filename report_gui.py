@@ -1,3 +1,6 @@
+import os
+import re
+import struct
 import tkinter as tk
 from tkinter import ttk, messagebox
 
@@ -23,15 +26,67 @@ def load_results(path="results.txt"):
         return f"(results.txt not found or unreadable)\n{e}"
 
 
+MOVES = {"U": (-1, 0), "R": (0, 1), "D": (1, 0), "L": (0, -1)}
+MOVE_ORDER = "URDL"  # direction index used by the binary form
+
+
+def decode_rle_path(text):
+    """'r c R12D3L' -> [(r, c), ...]; 'none' or empty -> []"""
+    parts = text.split()
+    if len(parts) < 2:
+        return []
+    r, c = int(parts[0]), int(parts[1])
+    coords = [(r, c)]
+    for ch, n in re.findall(r"([URDL])(\d*)", "".join(parts[2:])):
+        dr, dc = MOVES[ch]
+        for _ in range(int(n) if n else 1):
+            r, c = r + dr, c + dc
+            coords.append((r, c))
+    return coords
+
+
+def load_path_binary(data):
+    """Binary .mzp: 32-byte header, solver name, LEB128 (count << 2 | dir) runs"""
+    _, name_len, r, c, _, runs = struct.unpack_from("<4sIiiQQ", data, 0)
+    pos = 32
+    name = data[pos:pos + name_len].decode("utf-8", "replace")
+    pos += name_len
+    if r < 0:
+        return (name, [])
+    coords = [(r, c)]
+    for _ in range(runs):
+        v, shift = 0, 0
+        while True:
+            b = data[pos]
+            pos += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                break
+        dr, dc = MOVES[MOVE_ORDER[v & 3]]
+        for _ in range(v >> 2):
+            r, c = r + dr, c + dc
+            coords.append((r, c))
+    return (name, coords)
+
+
 def load_fastest_path(path="fastest.txt"):
+    """Solver name and path cells from fastest.txt ("rle ..." line, or the
+    older one "r c" pair per line) or from a binary .mzp file"""
     try:
-        with open(path, "r") as f:
-            lines = [line.rstrip("\n") for line in f]
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] == b"MZP1":
+            return load_path_binary(data)
+        lines = data.decode("utf-8", "replace").splitlines()
         if not lines:
             return ("", [])
         name = lines[0]
         coords = []
         for line in lines[1:]:
+            if line.startswith("rle "):
+                coords = decode_rle_path(line[4:])
+                break
             parts = line.split()
             if len(parts) == 2:
                 r, c = int(parts[0]), int(parts[1])
@@ -41,6 +96,65 @@ def load_fastest_path(path="fastest.txt"):
         return ("", [])
 
 
+TRACE_EXPAND, TRACE_PUSH, TRACE_LEVEL, TRACE_END = range(4)
+TRACE_FILES = ("trace.mzt", "bfs_trace.mzt")  # main --trace trace.mzt, BFS.cpp
+
+
+def load_trace(path):
+    """Search trace (.mzt): 16-byte header, then LEB128 (payload << 2 | type)
+    events. Returns (height, width, [(type, value), ...], complete) where
+    value is the cell id r * width + c for expand / push and the level for
+    level events; complete is False when the end marker is missing."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"MZT1":
+        raise ValueError(f"{path} is not a search trace")
+    h, w, _ = struct.unpack_from("<III", data, 4)
+    events, prev, pos = [], 0, 16
+    while pos < len(data):
+        v, shift = 0, 0
+        while True:
+            b = data[pos]
+            pos += 1
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80 or pos >= len(data):
+                break
+        kind, payload = v & 3, v >> 2
+        if kind == TRACE_END:
+            return (h, w, events, payload == len(events))
+        if kind == TRACE_LEVEL:
+            events.append((kind, payload))
+        else:
+            prev += (payload >> 1) ^ -(payload & 1)  # zigzag delta
+            events.append((kind, prev))
+    return (h, w, events, False)
+
+
+# Above this many cells one rectangle per cell is too slow for Tk; show the
+# image written by `main --render render.png` instead
+MAX_CANVAS_CELLS = 200 * 200
+RENDER_IMAGE = "render.png"
+
+
+class MazeImage(ttk.Frame):
+    """Scrollable view of a pre-rendered maze image (PNG or PPM)"""
+
+    def __init__(self, master, image_path, **kwargs):
+        super().__init__(master, **kwargs)
+        self.image = tk.PhotoImage(file=image_path)
+        self.canvas = tk.Canvas(self, width=min(self.image.width(), 900),
+                                height=min(self.image.height(), 900), bg="#000000",
+                                scrollregion=(0, 0, self.image.width(), self.image.height()))
+        xbar = ttk.Scrollbar(self, orient=tk.HORIZONTAL, command=self.canvas.xview)
+        ybar = ttk.Scrollbar(self, orient=tk.VERTICAL, command=self.canvas.yview)
+        self.canvas.configure(xscrollcommand=xbar.set, yscrollcommand=ybar.set)
+        xbar.pack(side=tk.BOTTOM, fill=tk.X)
+        ybar.pack(side=tk.RIGHT, fill=tk.Y)
+        self.canvas.pack(fill=tk.BOTH, expand=True)
+        self.canvas.create_image(0, 0, image=self.image, anchor=tk.NW)
+
+
 class MazeCanvas(ttk.Frame):
     def __init__(self, master, maze_data, path_coords, cell_size=24, **kwargs):
         super().__init__(master, **kwargs)
@@ -51,6 +165,7 @@ class MazeCanvas(ttk.Frame):
         height = self.h * self.cell
         self.canvas = tk.Canvas(self, width=width, height=height, bg="#000000")
         self.canvas.pack(fill=tk.BOTH, expand=True)
+        self.rects = {}
         self.draw()
 
     def draw(self):
@@ -62,13 +177,38 @@ class MazeCanvas(ttk.Frame):
                 fill = "#202020"  # empty
                 if ch == '1':
                     fill = "#444444"  # wall
+                elif '2' <= ch <= '9':
+                    shade = 0x20 + (ord(ch) - ord('0')) * 12
+                    fill = f"#{shade:02x}{shade // 2 + 0x10:02x}20"  # terrain, brighter = costlier
                 if (r, c) in self.path and ch not in ('S', 'E'):
                     fill = "#00bcd4"  # path cyan
                 if r == self.sr and c == self.sc:
                     fill = "#2ecc71"  # start green
                 if r == self.er and c == self.ec:
                     fill = "#e74c3c"  # end red
-                self.canvas.create_rectangle(x0, y0, x1, y1, outline="#1c1c1c", fill=fill)
+                self.rects[(r, c)] = self.canvas.create_rectangle(x0, y0, x1, y1, outline="#1c1c1c", fill=fill)
+
+    def replay(self, events, per_tick=None, on_done=None):
+        """Animate a search trace: pushed cells dim blue, expanded cells
+        brighter; the path, start and end keep their colours"""
+        per_tick = per_tick or max(1, len(events) // 400)
+        keep = self.path | {(self.sr, self.sc), (self.er, self.ec)}
+
+        def step(i):
+            for kind, value in events[i:i + per_tick]:
+                if kind == TRACE_LEVEL:
+                    continue
+                cell = divmod(value, self.w)
+                if cell in keep or cell not in self.rects:
+                    continue
+                fill = "#3f51b5" if kind == TRACE_EXPAND else "#283048"
+                self.canvas.itemconfigure(self.rects[cell], fill=fill)
+            if i + per_tick < len(events):
+                self.after(15, step, i + per_tick)
+            elif on_done:
+                on_done()
+
+        step(0)
 
 
 def main():
@@ -95,7 +235,32 @@ def main():
     right.pack(side=tk.RIGHT, fill=tk.BOTH, expand=True, padx=8, pady=8)
     title = f"Fastest: {fastest_name}" if fastest_name else "Fastest: (none)"
     ttk.Label(right, text=title, font=("Segoe UI", 12, "bold")).pack(anchor=tk.W)
-    MazeCanvas(right, maze, fastest_path, cell_size=24).pack(fill=tk.BOTH, expand=True)
+    h, w = maze[0], maze[1]
+    if h * w <= MAX_CANVAS_CELLS:
+        canvas = MazeCanvas(right, maze, fastest_path, cell_size=max(2, min(24, 900 // max(h, w))))
+        canvas.pack(fill=tk.BOTH, expand=True)
+        trace_path = next((p for p in TRACE_FILES if os.path.exists(p)), None)
+        if trace_path:
+            def start_replay():
+                try:
+                    th, tw, events, complete = load_trace(trace_path)
+                except Exception as e:
+                    messagebox.showerror("Error", f"Failed to load {trace_path}: {e}")
+                    return
+                if (th, tw) != (h, w):
+                    messagebox.showerror("Error", f"{trace_path} is for a {th}x{tw} maze")
+                    return
+                if not complete:
+                    messagebox.showwarning("Trace", f"{trace_path} is truncated; replaying what is there")
+                button.configure(state=tk.DISABLED)
+                canvas.replay(events, on_done=lambda: button.configure(state=tk.NORMAL))
+            button = ttk.Button(right, text=f"Replay search ({trace_path})", command=start_replay)
+            button.pack(anchor=tk.W, pady=(6, 0))
+    elif os.path.exists(RENDER_IMAGE):
+        MazeImage(right, RENDER_IMAGE).pack(fill=tk.BOTH, expand=True)
+    else:
+        ttk.Label(right, text=f"{h}x{w} is too large to draw here.\n"
+                              f"Run the solver with --render {RENDER_IMAGE} to get an image.").pack(anchor=tk.W)
 
     root.mainloop()
 